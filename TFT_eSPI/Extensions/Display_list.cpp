@@ -0,0 +1,261 @@
+ // This is part of the TFT_eSPI class and is associated with deferred drawing
+ // Loaded if DISPLAY_LIST is defined by user
+
+// How far back flush() looks for a command to merge with
+#define DL_MERGE_LOOKBACK 8
+
+/***************************************************************************************
+** Function name:           beginRecording
+** Description:             start recording the fills into a display list
+***************************************************************************************/
+bool TFT_eSPI::beginRecording(uint16_t size)
+{
+  if (_dlList) endRecording();
+  if (size == 0) return false;
+
+  _dlList = (dl_cmd_t*)malloc(size * sizeof(dl_cmd_t));
+  if (!_dlList) return false;
+
+  _dlSize = size;
+  _dlCount = 0;
+  return true;
+}
+
+/***************************************************************************************
+** Function name:           endRecording
+** Description:             flush the display list and stop recording
+***************************************************************************************/
+void TFT_eSPI::endRecording(void)
+{
+  if (!_dlList) return;
+
+  flush();
+  free(_dlList);
+  _dlList = nullptr;
+  _dlSize = 0;
+}
+
+/***************************************************************************************
+** Function name:           recordRect
+** Description:             clip a fill to the viewport and append it to the list
+***************************************************************************************/
+void TFT_eSPI::recordRect(int32_t x, int32_t y, int32_t w, int32_t h, rgb_t color)
+{
+  if (_vpOoB) return;
+
+  x+= _xDatum;
+  y+= _yDatum;
+
+  // Clipping, as fillRect
+  if ((x >= _vpW) || (y >= _vpH)) return;
+
+  if (x < _vpX) { w += x - _vpX; x = _vpX; }
+  if (y < _vpY) { h += y - _vpY; y = _vpY; }
+
+  if ((x + w) > _vpW) w = _vpW - x;
+  if ((y + h) > _vpH) h = _vpH - y;
+
+  if ((w < 1) || (h < 1)) return;
+
+  if (_dlCount >= _dlSize) flush();
+
+  dl_cmd_t* c = &_dlList[_dlCount++];
+  c->x = x;
+  c->y = y;
+  c->w = w;
+  c->h = h;
+  c->color = color;
+}
+
+// true if a is wholly inside b
+static inline bool dl_inside(const TFT_eSPI::dl_cmd_t* a, const TFT_eSPI::dl_cmd_t* b)
+{
+  return a->x >= b->x && a->y >= b->y && a->x + a->w <= b->x + b->w && a->y + a->h <= b->y + b->h;
+}
+
+static inline bool dl_overlap(const TFT_eSPI::dl_cmd_t* a, const TFT_eSPI::dl_cmd_t* b)
+{
+  return a->x < b->x + b->w && b->x < a->x + a->w && a->y < b->y + b->h && b->y < a->y + a->h;
+}
+
+// Extend a by b if the two make one rectangle of the same colour
+static inline bool dl_merge(TFT_eSPI::dl_cmd_t* a, const TFT_eSPI::dl_cmd_t* b)
+{
+  if (a->color != b->color) return false;
+
+  if (dl_inside(b, a)) return true;
+
+  if (a->y == b->y && a->h == b->h) {
+    if (a->x + a->w == b->x) { a->w += b->w; return true; }
+    if (b->x + b->w == a->x) { a->x = b->x; a->w += b->w; return true; }
+  }
+  if (a->x == b->x && a->w == b->w) {
+    if (a->y + a->h == b->y) { a->h += b->h; return true; }
+    if (b->y + b->h == a->y) { a->y = b->y; a->h += b->h; return true; }
+  }
+  return false;
+}
+
+/***************************************************************************************
+** Function name:           coalesce
+** Description:             drop overdrawn commands and merge neighbours, return count
+***************************************************************************************/
+uint16_t TFT_eSPI::coalesce(void)
+{
+  uint16_t n = 0;
+
+  for (uint16_t i = 0; i < _dlCount; i++) {
+    dl_cmd_t* c = &_dlList[i];
+
+    // Dropped if a later command paints over all of it
+    bool covered = false;
+    int32_t area = (int32_t)c->w * c->h;
+    for (uint16_t j = i + 1; j < _dlCount; j++) {
+      const dl_cmd_t* d = &_dlList[j];
+      if ((int32_t)d->w * d->h >= area && dl_inside(c, d)) { covered = true; break; }
+    }
+    if (covered) continue;
+
+    // Merge into an earlier command, the commands in between must not
+    // touch it, or moving it before them would change the result
+    bool merged = false;
+    for (int32_t k = n - 1; k >= 0 && k >= (int32_t)n - DL_MERGE_LOOKBACK; k--) {
+      if (dl_merge(&_dlList[k], c)) { merged = true; break; }
+      if (dl_overlap(&_dlList[k], c)) break;
+    }
+    if (merged) continue;
+
+    _dlList[n++] = *c;
+  }
+
+  return n;
+}
+
+/***************************************************************************************
+** Function name:           flush
+** Description:             send the display list coalesced in one transaction
+***************************************************************************************/
+void TFT_eSPI::flush(void)
+{
+  if (!_dlList || !_dlCount) return;
+
+  uint16_t n = coalesce();
+  _dlCount = 0; // Empty before the bus is used, setWindow() must not flush again
+
+  BUS_STATS_API(BUS_API_FLUSH);
+
+  // May be called with a transaction open, e.g. from setWindow(), it is then left open
+  bool ended = locked;
+  begin_nin_write();
+  bool inTrans = inTransaction;
+  inTransaction = true;
+
+  for (uint16_t i = 0; i < n; i++) {
+    const dl_cmd_t* c = &_dlList[i];
+    TFT_eeSPI::setWindow(c->x, c->y, c->x + c->w - 1, c->y + c->h - 1);
+    pushBlock(c->color, (int32_t)c->w * c->h);
+  }
+
+  inTransaction = inTrans;
+  if (ended) end_nin_write();
+}
+
+/***************************************************************************************
+** Function name:           drawPixel
+** Description:             record or draw a pixel
+***************************************************************************************/
+void TFT_eSPI::drawPixel(int32_t x, int32_t y, rgb_t color)
+{
+  if (_dlList) recordRect(x, y, 1, 1, color);
+  else TFT_Print::drawPixel(x, y, color);
+}
+
+/***************************************************************************************
+** Function name:           drawFastVLine
+** Description:             record or draw a vertical line
+***************************************************************************************/
+void TFT_eSPI::drawFastVLine(int32_t x, int32_t y, int32_t h, rgb_t color)
+{
+  if (_dlList) recordRect(x, y, 1, h, color);
+  else TFT_Print::drawFastVLine(x, y, h, color);
+}
+
+/***************************************************************************************
+** Function name:           drawFastHLine
+** Description:             record or draw a horizontal line
+***************************************************************************************/
+void TFT_eSPI::drawFastHLine(int32_t x, int32_t y, int32_t w, rgb_t color)
+{
+  if (_dlList) recordRect(x, y, w, 1, color);
+  else TFT_Print::drawFastHLine(x, y, w, color);
+}
+
+/***************************************************************************************
+** Function name:           fillRect
+** Description:             record or draw a filled rectangle
+***************************************************************************************/
+void TFT_eSPI::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, rgb_t color)
+{
+  if (_dlList) recordRect(x, y, w, h, color);
+  else TFT_Print::fillRect(x, y, w, h, color);
+}
+
+/***************************************************************************************
+** Function name:           fillSpans
+** Description:             record or draw n horizontal lines
+***************************************************************************************/
+void TFT_eSPI::fillSpans(const span_t *spans, uint16_t n, rgb_t color)
+{
+  if (_dlList) { for (uint16_t i = 0; i < n; i++) recordRect(spans[i].x, spans[i].y, spans[i].w, 1, color); }
+  else TFT_Print::fillSpans(spans, n, color);
+}
+
+/***************************************************************************************
+** Function name:           fillRects
+** Description:             record or draw n filled rectangles
+***************************************************************************************/
+void TFT_eSPI::fillRects(const rect_t *rects, uint16_t n, rgb_t color)
+{
+  if (_dlList) { for (uint16_t i = 0; i < n; i++) recordRect(rects[i].x, rects[i].y, rects[i].w, rects[i].h, color); }
+  else TFT_Print::fillRects(rects, n, color);
+}
+
+/***************************************************************************************
+** Function name:           fillScreen
+** Description:             record or clear the screen, everything before it is dropped
+***************************************************************************************/
+void TFT_eSPI::fillScreen(rgb_t color)
+{
+  if (_dlList) recordRect(-_xDatum, -_yDatum, width(), height(), color);
+  else TFT_Print::fillScreen(color);
+}
+
+/***************************************************************************************
+** Function name:           setWindow
+** Description:             flush the recorded commands before any other bus access
+***************************************************************************************/
+void TFT_eSPI::setWindow(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
+{
+  if (_dlCount) flush();
+  TFT_eeSPI::setWindow(x0, y0, x1, y1);
+}
+
+/***************************************************************************************
+** Function name:           readPixel
+** Description:             flush the recorded commands, then read the pixel
+***************************************************************************************/
+rgb_t TFT_eSPI::readPixel(int32_t x, int32_t y)
+{
+  if (_dlCount) flush();
+  return TFT_eeSPI::readPixel(x, y);
+}
+
+/***************************************************************************************
+** Function name:           readRect
+** Description:             flush the recorded commands, then read the rectangle
+***************************************************************************************/
+void TFT_eSPI::readRect(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *data)
+{
+  if (_dlCount) flush();
+  TFT_eeSPI::readRect(x, y, w, h, data);
+}
@@ -0,0 +1,48 @@
+ // This is part of the TFT_eSPI class and is associated with deferred drawing
+ // Loaded if DISPLAY_LIST is defined by user
+
+ public:
+
+  // A command is a clipped rectangle in screen coordinates
+  typedef struct {
+    int16_t x, y, w, h;
+    rgb_t   color;
+  } dl_cmd_t;
+
+           // Start recording, the fills (fillRect, fillSpans, fillRects, drawFastHLine, drawFastVLine, drawPixel
+           // and everything built on them) are appended to a list of up to "size" commands
+           // instead of being sent. Returns false if the list cannot be allocated.
+  bool     beginRecording(uint16_t size = 256);
+           // Send the recorded commands in one transaction, fully covered ones dropped,
+           // adjacent ones of the same colour merged. Recording continues.
+  void     flush(void);
+           // Flush and stop recording, the list is freed
+  void     endRecording(void);
+  bool     isRecording(void) { return _dlList != nullptr; }
+
+           // Recorded when recording, otherwise as in TFT_GFX
+  using    TFT_Print::drawPixel;
+  using    TFT_Print::fillScreen;
+  void     drawPixel(int32_t x, int32_t y, rgb_t color),
+           drawFastVLine(int32_t x, int32_t y, int32_t h, rgb_t color),
+           drawFastHLine(int32_t x, int32_t y, int32_t w, rgb_t color),
+           fillRect(int32_t x, int32_t y, int32_t w, int32_t h, rgb_t color),
+           fillSpans(const span_t *spans, uint16_t n, rgb_t color),
+           fillRects(const rect_t *rects, uint16_t n, rgb_t color),
+           fillScreen(rgb_t color);
+
+           // Any other bus access flushes the list first, so the drawing order is kept
+  void     setWindow(int32_t xs, int32_t ys, int32_t xe, int32_t ye);
+  rgb_t    readPixel(int32_t x, int32_t y);
+  void     readRect(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *data) override;
+
+ private:
+
+  dl_cmd_t* _dlList = nullptr;
+  uint16_t  _dlSize = 0;     // Capacity
+  uint16_t  _dlCount = 0;    // Commands recorded
+
+  void     recordRect(int32_t x, int32_t y, int32_t w, int32_t h, rgb_t color);
+  uint16_t coalesce(void);
+
+ protected:
@@ -359,6 +359,7 @@ bool TFT_CHAR::getUnicodeIndex(uint16_t unicode, uint16_t *index)
 // Expects file to be open
 void TFT_CHAR::drawGlyph(uint16_t code)
 {
+  BUS_STATS_API(BUS_API_DRAWGLYPH);
   rgb_t fg = textcolor;
   rgb_t bg = textbgcolor;
 
@@ -423,11 +424,16 @@ void TFT_CHAR::drawGlyph(uint16_t code)
 
     int16_t  fxs = cx;
     uint32_t fl = 0;
+    bool     solid = true; // Every pixel of the run is 0xFF
     int16_t  bxs = cx;
     uint32_t bl = 0;
     int16_t  bx = 0;
     uint8_t pixel;
 
+    // A run of inked pixels, blended in one span
+    uint8_t alpha[gWidth[gNum] + 1];
+    rgb_t   bgs[gWidth[gNum] + 1];
+
     startWrite(); // Avoid slow ESP32 transaction overhead for every pixel
 
     int16_t fillwidth  = 0;
@@ -488,25 +494,19 @@ void TFT_CHAR::drawGlyph(uint16_t code)
         if (pixel)
         {
           if (bl) { drawFastHLine( bxs, y + cy, bl, bg); bl = 0; }
-          if (pixel != 0xFF)
-          {
-            if (fl) {
-              if (fl==1) drawPixel(fxs, y + cy, fg);
-              else drawFastHLine( fxs, y + cy, fl, fg);
-              fl = 0;
-            }
-            if (getColor) bg = getColor(x + cx, y + cy);
-            drawPixel(x + cx, y + cy, alphaBlend(pixel, fg, bg));
-          }
-          else
-          {
-            if (fl==0) fxs = x + cx;
-            fl++;
-          }
+          if (fl==0) { fxs = x + cx; solid = true; }
+          if (pixel != 0xFF) solid = false;
+          alpha[fl] = pixel;
+          bgs[fl] = getColor ? getColor(x + cx, y + cy) : bg;
+          fl++;
         }
         else
         {
-          if (fl) { drawFastHLine( fxs, y + cy, fl, fg); fl = 0; }
+          if (fl) {
+            if (solid) drawFastHLine( fxs, y + cy, fl, fg);
+            else glyphSpan(fxs, y + cy, fg, bgs, alpha, fl);
+            fl = 0;
+          }
           if (_fillbg) {
             if (x >= bx) {
               if (bl==0) bxs = x + cx;
@@ -515,7 +515,11 @@ void TFT_CHAR::drawGlyph(uint16_t code)
           }
         }
       }
-      if (fl) { drawFastHLine( fxs, y + cy, fl, fg); fl = 0; }
+      if (fl) {
+        if (solid) drawFastHLine( fxs, y + cy, fl, fg);
+        else glyphSpan(fxs, y + cy, fg, bgs, alpha, fl);
+        fl = 0;
+      }
       if (bl) { drawFastHLine( bxs, y + cy, bl, bg); bl = 0; }
     }
 
@@ -541,6 +545,25 @@ void TFT_CHAR::drawGlyph(uint16_t code)
   last_cursor_x = cursor_x;
 }
 
+/***************************************************************************************
+** Function name:           glyphSpan
+** Description:             Clip a run of glyph pixels and blend it over its backgrounds
+*************************************************************************************x*/
+void TFT_CHAR::glyphSpan(int32_t x, int32_t y, rgb_t fg, rgb_t *bg, const uint8_t *alpha, int32_t len)
+{
+  if (_vpOoB) return;
+
+  x+= _xDatum;
+  y+= _yDatum;
+
+  if ((y < _vpY) || (y >= _vpH)) return;
+  if (x < _vpX) { bg += _vpX - x; alpha += _vpX - x; len -= _vpX - x; x = _vpX; }
+  if (x + len > _vpW) len = _vpW - x;
+  if (len < 1) return;
+
+  pushSpan(x, y, fg, bg, alpha, len);
+}
+
 /***************************************************************************************
 ** Function name:           showFont
 ** Description:             Page through all characters in font, td ms between screens
@@ -56,6 +56,8 @@ fontMetrics gFont = { nullptr, 0, 0, 0, 0, 0, 0, 0 };
 
   void     loadMetrics(void);
   uint32_t readInt32(void);
+           // Clip a run of glyph pixels to the viewport and blend it with pushSpan()
+  void     glyphSpan(int32_t x, int32_t y, rgb_t fg, rgb_t *bg, const uint8_t *alpha, int32_t len);
 
   uint8_t* fontPtr = nullptr;
 
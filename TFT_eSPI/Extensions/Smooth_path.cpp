@@ -0,0 +1,347 @@
+ // This is the TFT_ePath class, anti-aliased path filling by coverage accumulation
+ // Loaded if SMOOTH_PATH is defined by user
+
+/***************************************************************************************
+** Function name:           TFT_ePath
+** Description:             Class constructor
+***************************************************************************************/
+TFT_ePath::TFT_ePath(void)
+{
+  _edge = nullptr;
+  _count = 0;
+  _size = 0;
+  _sx = _sy = _cx = _cy = 0;
+  _error = false;
+}
+
+/***************************************************************************************
+** Function name:           ~TFT_ePath
+** Description:             Class destructor
+***************************************************************************************/
+TFT_ePath::~TFT_ePath(void)
+{
+  deletePath();
+}
+
+/***************************************************************************************
+** Function name:           reset
+** Description:             Empty the path
+***************************************************************************************/
+void TFT_ePath::reset(void)
+{
+  _count = 0;
+  _sx = _sy = _cx = _cy = 0;
+  _error = false;
+}
+
+/***************************************************************************************
+** Function name:           deletePath
+** Description:             Free the path memory
+***************************************************************************************/
+void TFT_ePath::deletePath(void)
+{
+  if (_edge) free(_edge);
+  _edge = nullptr;
+  _size = 0;
+  reset();
+}
+
+/***************************************************************************************
+** Function name:           addEdge
+** Description:             Append an edge, the list grows as needed
+***************************************************************************************/
+bool TFT_ePath::addEdge(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
+{
+  if (y0 == y1) return true; // Horizontal edges add no coverage
+
+  if (_count >= _size) {
+    if (_size >= 0x8000) return false;
+    uint16_t size = _size ? _size * 2 : 32;
+    path_edge_t *edge = (path_edge_t*)realloc(_edge, size * sizeof(path_edge_t));
+    if (!edge) return false;
+    _edge = edge;
+    _size = size;
+  }
+
+  path_edge_t *e = &_edge[_count++];
+  e->x0 = x0; e->y0 = y0;
+  e->x1 = x1; e->y1 = y1;
+  return true;
+}
+
+/***************************************************************************************
+** Function name:           moveTo
+** Description:             Start a new outline
+***************************************************************************************/
+void TFT_ePath::moveTo(float x, float y)
+{
+  close();
+  _sx = _cx = (int32_t)(x * PATH_ONE);
+  _sy = _cy = (int32_t)(y * PATH_ONE);
+}
+
+/***************************************************************************************
+** Function name:           lineTo
+** Description:             Straight line from the current point
+***************************************************************************************/
+void TFT_ePath::lineTo(float x, float y)
+{
+  lineToFixed((int32_t)(x * PATH_ONE), (int32_t)(y * PATH_ONE));
+}
+
+void TFT_ePath::lineToFixed(int32_t x, int32_t y)
+{
+  // A path with an edge missing would fill the wrong area, fill() fails instead
+  if (!addEdge(_cx, _cy, x, y)) _error = true;
+  _cx = x;
+  _cy = y;
+}
+
+// Lines for a curve with error k d / (8 n^2) for n lines, within 1/4 pixel of it
+static int32_t pathSegments(int32_t d, int32_t k)
+{
+  uint32_t n2 = ((uint32_t)d * k) >> (PATH_FRAC + 1);
+  int32_t n = 1;
+  while ((uint32_t)(n * n) < n2 && n < 64) n++;
+  return n;
+}
+
+static inline int32_t pathAbs(int32_t v) { return v < 0 ? -v : v; }
+
+/***************************************************************************************
+** Function name:           quadTo
+** Description:             Quadratic Bezier curve, flattened to lines
+***************************************************************************************/
+void TFT_ePath::quadTo(float cx, float cy, float x, float y)
+{
+  int32_t x0 = _cx, y0 = _cy;
+  int32_t x1 = (int32_t)(cx * PATH_ONE), y1 = (int32_t)(cy * PATH_ONE);
+  int32_t x2 = (int32_t)(x  * PATH_ONE), y2 = (int32_t)(y  * PATH_ONE);
+
+  // Flatness from the second difference
+  int32_t d = pathAbs(x0 - 2 * x1 + x2) + pathAbs(y0 - 2 * y1 + y2);
+  int32_t n = pathSegments(d, 1);
+
+  int64_t nn = (int64_t)n * n;
+  for (int32_t i = 1; i < n; i++) {
+    int64_t a = (int64_t)(n - i) * (n - i), b = 2LL * i * (n - i), c = (int64_t)i * i;
+    lineToFixed((int32_t)((a * x0 + b * x1 + c * x2) / nn), (int32_t)((a * y0 + b * y1 + c * y2) / nn));
+  }
+  lineToFixed(x2, y2);
+}
+
+/***************************************************************************************
+** Function name:           cubicTo
+** Description:             Cubic Bezier curve, flattened to lines
+***************************************************************************************/
+void TFT_ePath::cubicTo(float c1x, float c1y, float c2x, float c2y, float x, float y)
+{
+  int32_t x0 = _cx, y0 = _cy;
+  int32_t x1 = (int32_t)(c1x * PATH_ONE), y1 = (int32_t)(c1y * PATH_ONE);
+  int32_t x2 = (int32_t)(c2x * PATH_ONE), y2 = (int32_t)(c2y * PATH_ONE);
+  int32_t x3 = (int32_t)(x   * PATH_ONE), y3 = (int32_t)(y   * PATH_ONE);
+
+  // Flatness from the larger second difference, the error is 6 times that of a quad
+  int32_t da = pathAbs(x0 - 2 * x1 + x2) + pathAbs(y0 - 2 * y1 + y2);
+  int32_t db = pathAbs(x1 - 2 * x2 + x3) + pathAbs(y1 - 2 * y2 + y3);
+  int32_t n = pathSegments(da > db ? da : db, 6);
+
+  int64_t nnn = (int64_t)n * n * n;
+  for (int32_t i = 1; i < n; i++) {
+    int64_t s = n - i;
+    int64_t a = s * s * s, b = 3 * s * s * i, c = 3 * s * i * i, e = (int64_t)i * i * i;
+    lineToFixed((int32_t)((a * x0 + b * x1 + c * x2 + e * x3) / nnn),
+                (int32_t)((a * y0 + b * y1 + c * y2 + e * y3) / nnn));
+  }
+  lineToFixed(x3, y3);
+}
+
+/***************************************************************************************
+** Function name:           close
+** Description:             Line back to the start of the outline
+***************************************************************************************/
+void TFT_ePath::close(void)
+{
+  if (_cx != _sx || _cy != _sy) lineToFixed(_sx, _sy);
+}
+
+// Add the coverage of the part of an edge in one pixel row, the row is from y
+// top to top + PATH_ONE. acc[i] holds the change of the signed coverage at pixel i
+// of the w pixels from x left, 65536 is one pixel covered.
+static void pathRow(int32_t *acc, int32_t w, int32_t left, int32_t top, const int32_t *e)
+{
+  int32_t xa = e[0], ya = e[1], xb = e[2], yb = e[3];
+  int32_t s = 1;
+  if (ya > yb) { int32_t t = xa; xa = xb; xb = t; t = ya; ya = yb; yb = t; s = -1; }
+
+  int32_t bottom = top + PATH_ONE;
+  if (yb <= top || ya >= bottom) return;
+
+  // Clip to the row
+  int32_t yt = ya > top ? ya : top;
+  int32_t yB = yb < bottom ? yb : bottom;
+  int32_t xt = xa + (int32_t)((int64_t)(yt - ya) * (xb - xa) / (yb - ya)) - left;
+  int32_t xB = xa + (int32_t)((int64_t)(yB - ya) * (xb - xa) / (yb - ya)) - left;
+
+  // Walk left to right
+  if (xt > xB) { int32_t t = xt; xt = xB; xB = t; t = yt; yt = yB; yB = t; }
+  int32_t dx = xB - xt;
+  int32_t right = w << PATH_FRAC;
+
+  // Nothing right of the buffer counts
+  if (xt >= right) return;
+  if (xB > right) {
+    yB = yt + (int32_t)((int64_t)(right - xt) * (yB - yt) / dx);
+    xB = right;
+  }
+
+  // Left of the buffer the coverage is carried into the first pixel
+  if (xt < 0) {
+    int32_t ym = xB <= 0 ? yB : yt + (int32_t)((int64_t)(-xt) * (yB - yt) / dx);
+    acc[0] += s * pathAbs(ym - yt) * PATH_ONE;
+    if (xB <= 0) return;
+    xt = 0;
+    yt = ym;
+  }
+
+  int32_t xs = xt, ys = yt;
+  int32_t c = xt >> PATH_FRAC, cl = xB >> PATH_FRAC;
+  while (true) {
+    int32_t xe = (c + 1) << PATH_FRAC;
+    int32_t ye;
+    if (c >= cl || xe >= xB) { xe = xB; ye = yB; }
+    else ye = yt + (int32_t)((int64_t)(xe - xt) * (yB - yt) / dx);
+
+    // Area right of the edge in this pixel, the rest goes to the next one
+    int32_t d = s * pathAbs(ye - ys);
+    int32_t f = xs + xe - (c << (PATH_FRAC + 1)); // Twice the mean x in the pixel
+    acc[c]     += d * ((2 << PATH_FRAC) - f) / 2;
+    acc[c + 1] += d * f / 2;
+
+    if (xe >= xB) break;
+    xs = xe;
+    ys = ye;
+    c++;
+  }
+}
+
+// First and last row of an edge in fixed point, and the order of the edges by first row
+static inline int32_t pathTop(const int32_t *e)    { return e[1] < e[3] ? e[1] : e[3]; }
+static inline int32_t pathBottom(const int32_t *e) { return e[1] > e[3] ? e[1] : e[3]; }
+
+static int pathOrder(const void *a, const void *b)
+{
+  int32_t ta = pathTop((const int32_t *)a), tb = pathTop((const int32_t *)b);
+  return (ta > tb) - (ta < tb);
+}
+
+/***************************************************************************************
+** Function name:           fill
+** Description:             Fill the path anti-aliased
+***************************************************************************************/
+bool TFT_ePath::fill(TFT_eSPI *tft, rgb_t color, rgb_t bg_color, bool nonZero)
+{
+  close();
+  if (_error) return false;
+  if (!_count || tft->_vpOoB) return true;
+
+  // Bounding box in whole pixels, within the viewport
+  int32_t x0 = INT32_MAX, y0 = INT32_MAX, x1 = INT32_MIN, y1 = INT32_MIN;
+  for (uint16_t i = 0; i < _count; i++) {
+    const path_edge_t *e = &_edge[i];
+    if (e->x0 < x0) x0 = e->x0;
+    if (e->x1 < x0) x0 = e->x1;
+    if (e->x0 > x1) x1 = e->x0;
+    if (e->x1 > x1) x1 = e->x1;
+    if (e->y0 < y0) y0 = e->y0;
+    if (e->y1 < y0) y0 = e->y1;
+    if (e->y0 > y1) y1 = e->y0;
+    if (e->y1 > y1) y1 = e->y1;
+  }
+  x0 >>= PATH_FRAC;
+  y0 >>= PATH_FRAC;
+  x1 = (x1 + PATH_ONE - 1) >> PATH_FRAC;
+  y1 = (y1 + PATH_ONE - 1) >> PATH_FRAC;
+
+  int32_t xDatum = tft->_xDatum, yDatum = tft->_yDatum;
+  if (x0 < tft->_vpX - xDatum) x0 = tft->_vpX - xDatum;
+  if (y0 < tft->_vpY - yDatum) y0 = tft->_vpY - yDatum;
+  if (x1 > tft->_vpW - xDatum) x1 = tft->_vpW - xDatum;
+  if (y1 > tft->_vpH - yDatum) y1 = tft->_vpH - yDatum;
+  if (x1 <= x0 || y1 <= y0) return true;
+
+  // Coverage changes, then the row of backgrounds and alphas, and the active edges
+  int32_t w = x1 - x0;
+  size_t  size = (w + 2) * sizeof(int32_t) + w * sizeof(rgb_t) + _count * sizeof(uint16_t) + w;
+  int32_t *acc = (int32_t*)malloc(size);
+  if (!acc) return false;
+  rgb_t    *rowBg    = (rgb_t *)(acc + w + 2);
+  uint16_t *act      = (uint16_t *)(rowBg + w);
+  uint8_t  *rowAlpha = (uint8_t *)(act + _count);
+
+  // Edges in the order of their first row, only those crossing a row are stepped through
+  qsort(_edge, _count, sizeof(path_edge_t), pathOrder);
+  uint16_t na = 0, next = 0;
+
+  tft->startWrite();
+
+  for (int32_t y = y0; y < y1; y++) {
+    memset(acc, 0, (w + 2) * sizeof(int32_t));
+
+    int32_t top = y << PATH_FRAC, bottom = top + PATH_ONE;
+
+    // Drop the edges that ended above the row, add the ones starting in it
+    uint16_t k = 0;
+    for (uint16_t i = 0; i < na; i++) if (pathBottom(&_edge[act[i]].x0) > top) act[k++] = act[i];
+    na = k;
+    while (next < _count && pathTop(&_edge[next].x0) < bottom) {
+      if (pathBottom(&_edge[next].x0) > top) act[na++] = next;
+      next++;
+    }
+
+    for (uint16_t i = 0; i < na; i++) pathRow(acc, w, x0 << PATH_FRAC, top, &_edge[act[i]].x0);
+
+    // Sum the changes into the coverage of each pixel and emit runs
+    int32_t cover = 0;
+    int32_t fs = 0, fl = 0; // Fully covered run start and length
+    int32_t ps = 0, pl = 0; // Partly covered run start and length
+    for (int32_t i = 0; i <= w; i++) {
+      uint32_t a = 0;
+      if (i < w) {
+        cover += acc[i];
+        a = pathAbs(cover);
+        if (nonZero) { if (a > 0x10000) a = 0x10000; }
+        else {
+          a &= 0x1FFFF;
+          if (a > 0x10000) a = 0x20000 - a;
+        }
+        a >>= 8;
+        if (a > 255) a = 255;
+      }
+
+      if (fl && a != 255) { tft->drawFastHLine(x0 + fs, y, fl, color); fl = 0; }
+
+      // A partly covered run is blended in the row buffer and sent in one window
+      if (pl && (a == 0 || a == 255)) {
+        tft->pushSpan(x0 + ps + xDatum, y + yDatum, color, rowBg + ps, rowAlpha + ps, pl);
+        pl = 0;
+      }
+
+      if (a == 255) {
+        if (!fl) fs = i;
+        fl++;
+      }
+      else if (a) {
+        if (!pl) ps = i;
+        rowAlpha[i] = a;
+        rowBg[i] = (bg_color == 0x00FFFFFF) ? tft->readPixel(x0 + i, y) : bg_color;
+        pl++;
+      }
+    }
+  }
+
+  tft->endWrite();
+
+  free(acc);
+  return true;
+}
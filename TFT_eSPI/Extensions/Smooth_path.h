@@ -0,0 +1,52 @@
+/***************************************************************************************
+// The following class builds a path of lines and Bezier curves and fills it anti-aliased
+// on a TFT_eSPI or TFT_eSprite. Loaded if SMOOTH_PATH is defined by user.
+***************************************************************************************/
+
+// Coordinates are kept in fixed point, 1/256 pixel
+#define PATH_FRAC 8
+#define PATH_ONE  (1 << PATH_FRAC)
+
+class TFT_ePath {
+
+ public:
+
+  TFT_ePath(void);
+  ~TFT_ePath(void);
+
+           // Empty the path and clear an error, the memory is kept for the next one
+  void     reset(void);
+           // Free the path memory
+  void     deletePath(void);
+
+           // Start a new outline at x,y, the one before is closed
+  void     moveTo(float x, float y);
+           // Straight line from the current point
+  void     lineTo(float x, float y);
+           // Quadratic Bezier curve with control point cx,cy
+  void     quadTo(float cx, float cy, float x, float y);
+           // Cubic Bezier curve with control points c1x,c1y and c2x,c2y
+  void     cubicTo(float c1x, float c1y, float c2x, float c2y, float x, float y);
+           // Line back to the start of the outline
+  void     close(void);
+
+           // Fill the path anti-aliased, blended with bg_color or with the pixels read back
+           // if bg_color is 0x00FFFFFF. Overlaps are filled by the non-zero winding rule,
+           // or by the even-odd rule if nonZero is false. Returns false if out of memory,
+           // also if an edge could not be added to the path, nothing is drawn then.
+  bool     fill(TFT_eSPI *tft, rgb_t color, rgb_t bg_color = 0x00FFFFFF, bool nonZero = true);
+
+ private:
+
+  typedef struct { int32_t x0, y0, x1, y1; } path_edge_t;
+
+  path_edge_t *_edge;
+  uint16_t  _count, _size;
+
+  int32_t   _sx, _sy;  // Start of the outline
+  int32_t   _cx, _cy;  // Current point
+  bool      _error;    // An edge was lost, set until reset()
+
+  bool     addEdge(int32_t x0, int32_t y0, int32_t x1, int32_t y1);
+  void     lineToFixed(int32_t x, int32_t y);
+};
@@ -74,8 +74,9 @@ void* TFT_eSprite::createSprite(int16_t w, int16_t h, uint8_t frames)
   _img    = (uint16_t*) _img8;
   _img4   = _img8;
 
+  // Frames start on a word boundary for pushDiff()
   if ( (_bpp == 16) && (frames > 1) ) {
-    _img8_2 = _img8 + (w * h * 2 + 1);
+    _img8_2 = _img8 + ((w * h + 2) & ~1) * 2;
   }
 
   // ESP32 only 16bpp check
@@ -85,7 +86,7 @@ void* TFT_eSprite::createSprite(int16_t w, int16_t h, uint8_t frames)
   //else Serial.println("Not a DMA capable Sprite pointer _img8_2");
 
   if ( (_bpp == 8) && (frames > 1) ) {
-    _img8_2 = _img8 + (w * h + 1);
+    _img8_2 = _img8 + ((w * h + 4) & ~3);
   }
 
   // This is to make it clear what pointer size is expected to be used
@@ -103,6 +104,9 @@ void* TFT_eSprite::createSprite(int16_t w, int16_t h, uint8_t frames)
 
     rotation = 0;
     setViewport(0, 0, _dwidth, _dheight);
+    DIRTY_CLEAR();
+    DIRTY_MARK(0, 0, _dwidth, _dheight);
+    _diffValid = false;
     setPivot(_iwidth/2, _iheight/2);
     return _img8_1;
   }
@@ -165,13 +169,13 @@ void* TFT_eSprite::callocSprite(int16_t w, int16_t h, uint8_t frames)
 #if defined (ESP32) && defined (CONFIG_SPIRAM_SUPPORT)
     if ( psramFound() && _psram_enable && !_tft->DMA_Enabled)
     {
-      ptr8 = ( uint8_t*) ps_calloc(frames * w * h + frames, sizeof(uint16_t));
+      ptr8 = ( uint8_t*) ps_calloc(frames * ((w * h + 2) & ~1), sizeof(uint16_t));
       //Serial.println("PSRAM");
     }
     else
 #endif
     {
-      ptr8 = ( uint8_t*) calloc(frames * w * h + frames, sizeof(uint16_t));
+      ptr8 = ( uint8_t*) calloc(frames * ((w * h + 2) & ~1), sizeof(uint16_t));
       //Serial.println("Normal RAM");
     }
   }
@@ -179,10 +183,10 @@ void* TFT_eSprite::callocSprite(int16_t w, int16_t h, uint8_t frames)
   else if (_bpp == 8)
   {
 #if defined (ESP32) && defined (CONFIG_SPIRAM_SUPPORT)
-    if ( psramFound() && _psram_enable ) ptr8 = ( uint8_t*) ps_calloc(frames * w * h + frames, sizeof(uint8_t));
+    if ( psramFound() && _psram_enable ) ptr8 = ( uint8_t*) ps_calloc(frames * ((w * h + 4) & ~3), sizeof(uint8_t));
     else
 #endif
-    ptr8 = ( uint8_t*) calloc(frames * w * h + frames, sizeof(uint8_t));
+    ptr8 = ( uint8_t*) calloc(frames * ((w * h + 4) & ~3), sizeof(uint8_t));
   }
 
   else if (_bpp == 4)
@@ -658,6 +662,7 @@ void TFT_eSprite::getRotatedBounds(int16_t angle, int16_t w, int16_t h, int16_t
 ***************************************************************************************/
 void TFT_eSprite::pushSprite(int32_t x, int32_t y)
 {
+  BUS_STATS_API(BUS_API_PUSHSPRITE);
   if (!_created) return;
 
   if (_bpp == 16)
@@ -681,6 +686,7 @@ void TFT_eSprite::pushSprite(int32_t x, int32_t y)
 ***************************************************************************************/
 void TFT_eSprite::pushSprite(int32_t x, int32_t y, uint16_t transp)
 {
+  BUS_STATS_API(BUS_API_PUSHSPRITE);
   if (!_created) return;
 
   if (_bpp == 16)
@@ -800,6 +806,7 @@ bool TFT_eSprite::pushToSprite(TFT_eSprite *dspr, int32_t x, int32_t y, uint16_t
 ***************************************************************************************/
 bool TFT_eSprite::pushSprite(int32_t tx, int32_t ty, int32_t sx, int32_t sy, int32_t sw, int32_t sh)
 {
+  BUS_STATS_API(BUS_API_PUSHSPRITE);
   if (!_created) return false;
 
   // Perform window boundary checks and crop if needed
@@ -891,6 +898,299 @@ bool TFT_eSprite::pushSprite(int32_t tx, int32_t ty, int32_t sx, int32_t sy, int
 }
 
 
+/***************************************************************************************
+** Function name:           drawBand
+** Description:             Draw rows by to by + h - 1 of a scene into the sprite
+***************************************************************************************/
+bool TFT_eSprite::drawBand(int32_t by, int32_t h, bandScene_t scene, void *param, rgb_t bg)
+{
+  if (!_created || !scene || h < 1) return false;
+  if (h > _dheight) h = _dheight;
+
+  // The viewport is used for the band offset, keep the user's one
+  int32_t  xDatum  = _xDatum,  yDatum  = _yDatum;
+  int32_t  xWidth  = _xWidth,  yHeight = _yHeight;
+  int32_t  vpX = _vpX, vpY = _vpY, vpW = _vpW, vpH = _vpH;
+  bool     vpDatum = _vpDatum, vpOoB = _vpOoB;
+
+  // Clear the band with the datum at 0,0 so memset can be used
+  _xDatum = 0;  _yDatum = 0;
+  _xWidth = _dwidth;  _yHeight = _dheight;
+  _vpX = 0;  _vpY = 0;  _vpW = _dwidth;  _vpH = _dheight;
+  _vpDatum = false;  _vpOoB = false;
+  fillSprite(bg);
+
+  // Scene row by is band row 0, drawing outside the band is clipped
+  _yDatum  = -by;
+  _yHeight = h;
+  _vpH     = h;
+
+  // No bus transaction from inherited functions, the band may be drawn on another core
+  bool lock = locked;
+  locked = false;
+  scene(this, param);
+  locked = lock;
+
+  _xDatum  = xDatum;  _yDatum  = yDatum;
+  _xWidth  = xWidth;  _yHeight = yHeight;
+  _vpX = vpX;  _vpY = vpY;  _vpW = vpW;  _vpH = vpH;
+  _vpDatum = vpDatum;  _vpOoB = vpOoB;
+
+  return true;
+}
+
+
+/***************************************************************************************
+** Function name:           pushBanded
+** Description:             Render a scene to the TFT a band (this sprite) at a time
+***************************************************************************************/
+bool TFT_eSprite::pushBanded(int32_t tx, int32_t ty, int32_t h, bandScene_t scene, void *param, rgb_t bg)
+{
+  BUS_STATS_API(BUS_API_PUSHSPRITE);
+  if (!_created || !scene || h < 1) return false;
+
+  for (int32_t by = 0; by < h; by += _dheight)
+  {
+    int32_t bh = h - by;
+    if (bh > _dheight) bh = _dheight;
+
+    drawBand(by, bh, scene, param, bg);
+
+    // One window for the whole band, not cropped to a viewport datum
+    bool vpDatum = _vpDatum;
+    _vpDatum = false;
+    pushSprite(tx, ty + by, 0, 0, _dwidth, bh);
+    _vpDatum = vpDatum;
+  }
+
+  DIRTY_CLEAR(); // Everything drawn has been pushed
+
+  return true;
+}
+
+
+#ifdef SPRITE_DIRTY
+
+/***************************************************************************************
+** Function name:           markDirty
+** Description:             Add an area to the list of written areas
+***************************************************************************************/
+void TFT_eSprite::markDirty(int32_t x, int32_t y, int32_t w, int32_t h)
+{
+  // Runs of writes land in the rectangle the last one did
+  if (_dirtyLast < _dirtyCount) {
+    dirty_rect_t* r = &_dirty[_dirtyLast];
+    if (x >= r->x0 && y >= r->y0 && x + w <= r->x1 && y + h <= r->y1) return;
+  }
+
+  // Logical sprite size, swapped for rotated 1bpp Sprites
+  int32_t sw = _dwidth, sh = _dheight;
+  if (_bpp == 1 && (rotation & 1)) { sw = _dheight; sh = _dwidth; }
+
+  int32_t x0 = x, y0 = y, x1 = x + w, y1 = y + h;
+  if (x0 < 0) x0 = 0;
+  if (y0 < 0) y0 = 0;
+  if (x1 > sw) x1 = sw;
+  if (y1 > sh) y1 = sh;
+  if (x0 >= x1 || y0 >= y1) return;
+
+  // Most writes land in an area already marked
+  for (uint8_t i = 0; i < _dirtyCount; i++) {
+    dirty_rect_t* r = &_dirty[i];
+    if (x0 >= r->x0 && y0 >= r->y0 && x1 <= r->x1 && y1 <= r->y1) { _dirtyLast = i; return; }
+  }
+
+  // Absorb every rectangle the area overlaps or touches, the grown area may
+  // then touch others so repeat until none is left
+  bool merged = true;
+  while (merged) {
+    merged = false;
+    for (uint8_t i = 0; i < _dirtyCount; i++) {
+      dirty_rect_t* r = &_dirty[i];
+      if (x0 > r->x1 || r->x0 > x1 || y0 > r->y1 || r->y0 > y1) continue;
+      if (r->x0 < x0) x0 = r->x0;
+      if (r->y0 < y0) y0 = r->y0;
+      if (r->x1 > x1) x1 = r->x1;
+      if (r->y1 > y1) y1 = r->y1;
+      *r = _dirty[--_dirtyCount];
+      merged = true;
+      break;
+    }
+  }
+
+  // List full, merge with the rectangle that grows least
+  if (_dirtyCount >= SPRITE_DIRTY_RECTS) {
+    uint8_t best = 0;
+    int32_t bestGrowth = INT32_MAX;
+    for (uint8_t i = 0; i < _dirtyCount; i++) {
+      dirty_rect_t* r = &_dirty[i];
+      int32_t ux0 = x0 < r->x0 ? x0 : r->x0, uy0 = y0 < r->y0 ? y0 : r->y0;
+      int32_t ux1 = x1 > r->x1 ? x1 : r->x1, uy1 = y1 > r->y1 ? y1 : r->y1;
+      int32_t growth = (ux1 - ux0) * (uy1 - uy0) - (r->x1 - r->x0) * (r->y1 - r->y0);
+      if (growth < bestGrowth) { bestGrowth = growth; best = i; }
+    }
+    dirty_rect_t* r = &_dirty[best];
+    if (r->x0 < x0) x0 = r->x0;
+    if (r->y0 < y0) y0 = r->y0;
+    if (r->x1 > x1) x1 = r->x1;
+    if (r->y1 > y1) y1 = r->y1;
+    *r = _dirty[--_dirtyCount];
+    markDirty(x0, y0, x1 - x0, y1 - y0); // The union may touch others
+    return;
+  }
+
+  _dirtyLast = _dirtyCount;
+  dirty_rect_t* r = &_dirty[_dirtyCount++];
+  r->x0 = x0;
+  r->y0 = y0;
+  r->x1 = x1;
+  r->y1 = y1;
+}
+
+
+/***************************************************************************************
+** Function name:           pushDirty
+** Description:             Push the written areas to the TFT and clear the list
+***************************************************************************************/
+void TFT_eSprite::pushDirty(int32_t x, int32_t y)
+{
+  BUS_STATS_API(BUS_API_PUSHSPRITE);
+  if (!_created || !_dirtyCount) return;
+
+  _tft->startWrite();
+  for (uint8_t i = 0; i < _dirtyCount; i++) {
+    dirty_rect_t* r = &_dirty[i];
+    pushSprite(x + r->x0, y + r->y0, r->x0, r->y0, r->x1 - r->x0, r->y1 - r->y0);
+  }
+  _tft->endWrite();
+
+  _dirtyCount = 0;
+}
+
+#endif
+
+
+/***************************************************************************************
+** Function name:           diffSkip
+** Description:             Return the first pixel from i on that differs, or n
+***************************************************************************************/
+// Both frames are word aligned, so are their rows at the same offset
+static int32_t diffSkip(const uint8_t* c, const uint8_t* p, int32_t i, int32_t n, uint8_t bp)
+{
+  int32_t b = i * bp, e = n * bp;
+
+  while (b < e && ((uintptr_t)(c + b) & 3)) {
+    if (c[b] != p[b]) return b / bp;
+    b++;
+  }
+
+  // Word at a time over the unchanged part
+  while (b + 4 <= e && *(const uint32_t*)(c + b) == *(const uint32_t*)(p + b)) b += 4;
+
+  while (b < e) {
+    if (c[b] != p[b]) return b / bp;
+    b++;
+  }
+
+  return n;
+}
+
+// Return the first pixel from i on that is unchanged, or n
+static int32_t diffSame(const uint8_t* c, const uint8_t* p, int32_t i, int32_t n, uint8_t bp)
+{
+  if (bp == 2) {
+    while (i < n && (c[i<<1] != p[i<<1] || c[(i<<1) + 1] != p[(i<<1) + 1])) i++;
+  }
+  else {
+    while (i < n && c[i] != p[i]) i++;
+  }
+  return i;
+}
+
+/***************************************************************************************
+** Function name:           pushDiff
+** Description:             Push what changed since the last pushDiff, then swap frames
+***************************************************************************************/
+void TFT_eSprite::pushDiff(int32_t x, int32_t y)
+{
+  BUS_STATS_API(BUS_API_PUSHSPRITE);
+  if (!_created) return;
+
+  // Needs two frames and a byte or two per pixel
+  if (_img8_1 == _img8_2 || _bpp < 8) { pushSprite(x, y); return; }
+
+  uint8_t  bp = _bpp >> 3;
+  uint8_t* cur  = _img8;
+  uint8_t* prev = (cur == _img8_1) ? _img8_2 : _img8_1;
+  int32_t  rowBytes = _iwidth * bp;
+
+  // The other frame does not yet hold what is on the screen
+  if (!_diffValid) {
+    pushSprite(x, y);
+    memcpy(prev, cur, rowBytes * _iheight);
+    frameBuffer(cur == _img8_1 ? 2 : 1);
+    _diffValid = true;
+    DIRTY_CLEAR();
+    return;
+  }
+
+  _tft->startWrite();
+  for (int32_t yp = 0; yp < _dheight; yp++) {
+    const uint8_t* c = cur  + yp * rowBytes;
+    uint8_t*       p = prev + yp * rowBytes;
+
+    int32_t xs = diffSkip(c, p, 0, _dwidth, bp);
+    while (xs < _dwidth) {
+      int32_t xe = diffSame(c, p, xs + 1, _dwidth, bp);
+
+      // Runs only a few pixels apart go in one window
+      while (xe < _dwidth) {
+        int32_t nx = diffSkip(c, p, xe, _dwidth, bp);
+        if (nx >= _dwidth || nx - xe >= SPRITE_DIFF_GAP) break;
+        xe = diffSame(c, p, nx + 1, _dwidth, bp);
+      }
+
+      pushSprite(x + xs, y + yp, xs, yp, xe - xs, 1);
+
+      // The next frame is drawn over this one, so bring the other one up to date
+      memcpy(p + xs * bp, c + xs * bp, (xe - xs) * bp);
+
+      xs = diffSkip(c, p, xe, _dwidth, bp);
+    }
+  }
+  _tft->endWrite();
+
+  frameBuffer(cur == _img8_1 ? 2 : 1);
+  DIRTY_CLEAR();
+}
+
+
+/***************************************************************************************
+** Function name:           readRect
+** Description:             Read a rectangle of pixels as 565 colours
+***************************************************************************************/
+void TFT_eSprite::readRect(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *data)
+{
+  if (!_created) return;
+
+  int32_t x0 = x + _xDatum, y0 = y + _yDatum, dw = w;
+  if (!clipAddrWindow(&x, &y, &w, &h)) return;
+  data += (x - x0) + (y - y0) * dw;
+
+  // readPixel() adds the datum back
+  x -= _xDatum;
+  y -= _yDatum;
+
+  for (int32_t j = 0; j < h; j++) {
+    uint8_t *p = (uint8_t *)(data + j * dw);
+    for (int32_t i = 0; i < w; i++) {
+      uint16_t c = color24to16(readPixel(x + i, y + j));
+      *p++ = c >> 8; // High byte first, as pushRect() sends them
+      *p++ = c;
+    }
+  }
+}
+
 /***************************************************************************************
 ** Function name:           readPixelValue
 ** Description:             Read the color map index of a pixel at defined coordinates
@@ -1036,6 +1336,8 @@ void  TFT_eSprite::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_
 
   PI_CLIP;
 
+  DIRTY_MARK(x, y, dw, dh);
+
   if (_bpp == 16) // Plot a 16 bpp image into a 16 bpp Sprite
   {
     // Pointer within original image
@@ -1179,6 +1481,8 @@ void  TFT_eSprite::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const u
 
   PI_CLIP;
 
+  DIRTY_MARK(x, y, dw, dh);
+
   if (_bpp == 16) // Plot a 16 bpp image into a 16 bpp Sprite
   {
     for (int32_t yp = dy; yp < dy + dh; yp++)
@@ -1293,6 +1597,8 @@ void TFT_eSprite::pushColor(rgb_t color)
 {
   if (!_created ) return;
 
+  DIRTY_MARK(_xptr, _yptr, 1, 1);
+
   // Write the colour to RAM in set window
   if (_bpp == 16)
     _img [_xptr + _yptr * _iwidth] = (uint16_t) (color >> 8) | (color << 8);
@@ -1357,6 +1663,8 @@ void TFT_eSprite::writeColor(rgb_t color)
 {
   if (!_created ) return;
 
+  DIRTY_MARK(_xptr, _yptr, 1, 1);
+
   // Write 16-bit RGB 565 encoded colour to RAM
   if (_bpp == 16) _img [_xptr + _yptr * _iwidth] = color;
 
@@ -1425,6 +1733,8 @@ void TFT_eSprite::scroll(int16_t dx, int16_t dy)
     return;
   }
 
+  DIRTY_MARK(_sx, _sy, _sw, _sh);
+
   // Fetch the scroll area width and height set by setScrollRect()
   uint32_t w  = _sw - abs(dx); // line width to copy
   uint32_t h  = _sh - abs(dy); // lines to copy
@@ -1522,6 +1832,7 @@ void TFT_eSprite::fillSprite(uint32_t color)
   // Use memset if possible as it is super fast
   if(_xDatum == 0 && _yDatum == 0  &&  _xWidth == width())
   {
+    DIRTY_MARK(0, 0, _xWidth, _yHeight);
     if(_bpp == 16) {
       if ( (uint8_t)color == (uint8_t)(color>>8) ) {
         memset(_img,  (uint8_t)color, _iwidth * _yHeight * 2);
@@ -1639,6 +1950,8 @@ void TFT_eSprite::drawPixel(int32_t x, int32_t y, uint32_t color)
   // Range checking
   if ((x < _vpX) || (y < _vpY) ||(x >= _vpW) || (y >= _vpH)) return;
 
+  DIRTY_MARK(x, y, 1, 1);
+
   if (_bpp == 16)
   {
     color = (color >> 8) | (color << 8);
@@ -1712,6 +2025,10 @@ void TFT_eSprite::drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint3
 
   if (y0 < y1) ystep = 1;
 
+  // Only the pixels in the viewport are stepped through
+  if (!clipBresenham(&x0, &y0, &x1, &err, dx, dy, ystep, steep)) return;
+  xs = x0;
+
   // Split into steep and not steep for FastH/V separation
   if (steep) {
     for (; x0 <= x1; x0++) {
@@ -1763,6 +2080,8 @@ void TFT_eSprite::drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color)
 
   if (h < 1) return;
 
+  DIRTY_MARK(x, y, 1, h);
+
   if (_bpp == 16)
   {
     color = (color >> 8) | (color << 8);
@@ -1824,6 +2143,8 @@ void TFT_eSprite::drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color)
 
   if (w < 1) return;
 
+  DIRTY_MARK(x, y, w, 1);
+
   if (_bpp == 16)
   {
     color = (color >> 8) | (color << 8);
@@ -1867,6 +2188,166 @@ void TFT_eSprite::drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color)
 }
 
 
+/***************************************************************************************
+** Function name:           fillSpans
+** Description:             draw n horizontal lines
+***************************************************************************************/
+void TFT_eSprite::fillSpans(const span_t *spans, uint16_t n, uint32_t color)
+{
+  if (!_created || _vpOoB || !n) return;
+
+  // Pixels packed in bytes are left to drawFastHLine()
+  if (_bpp != 16 && _bpp != 8) {
+    for (const span_t *s = spans; s < spans + n; s++) drawFastHLine(s->x, s->y, s->w, color);
+    return;
+  }
+
+  if (_bpp == 16) color = (color >> 8) | (color << 8);
+  else color = (color & 0xE000)>>8 | (color & 0x0700)>>6 | (color & 0x0018)>>3;
+
+  // Area written, marked dirty once for the batch
+  int32_t x0 = _vpW, y0 = _vpH, x1 = _vpX, y1 = _vpY;
+
+  for (const span_t *s = spans; s < spans + n; s++) {
+    int32_t x = s->x + _xDatum;
+    int32_t y = s->y + _yDatum;
+    int32_t w = s->w;
+
+    // Clipping
+    if ((y < _vpY) || (x >= _vpW) || (y >= _vpH)) continue;
+
+    if (x < _vpX) { w += x - _vpX; x = _vpX; }
+
+    if ((x + w) > _vpW) w = _vpW - x;
+
+    if (w < 1) continue;
+
+    if (x < x0) x0 = x;
+    if (x + w > x1) x1 = x + w;
+    if (y < y0) y0 = y;
+    if (y >= y1) y1 = y + 1;
+
+    if (_bpp == 16) {
+      uint16_t *p = _img + _iwidth * y + x;
+      while (w--) *p++ = (uint16_t) color;
+    }
+    else memset(_img8 + _iwidth * y + x, (uint8_t)color, w);
+  }
+
+  DIRTY_MARK(x0, y0, x1 - x0, y1 - y0);
+}
+
+
+/***************************************************************************************
+** Function name:           fillRects
+** Description:             draw n filled rectangles
+***************************************************************************************/
+void TFT_eSprite::fillRects(const rect_t *rects, uint16_t n, uint32_t color)
+{
+  if (!_created || _vpOoB) return;
+
+  // The Sprite has no transaction to share, each one is clipped and filled by fillRect()
+  for (const rect_t *r = rects; r < rects + n; r++) fillRect(r->x, r->y, r->w, r->h, color);
+}
+
+
+/***************************************************************************************
+** Function name:           fillRectVGradient
+** Description:             draw a filled rectangle with a vertical colour gradient
+***************************************************************************************/
+void TFT_eSprite::fillRectVGradient(int16_t x, int16_t y, int16_t w, int16_t h, rgb_t color1, rgb_t color2)
+{
+  if (!_created || _vpOoB || (w < 1) || (h < 1)) return;
+
+  gradient_t gr;
+  gradientStart(&gr, color1, color2, h);
+
+  for (int32_t j = 0; j < h; j++) {
+    if (!_gradDither) drawFastHLine(x, y + j, w, gradient565(&gr, 0, 0, false));
+    else {
+      // Dither by position in the Sprite
+      int32_t yd = y + j + _yDatum;
+      for (int32_t i = 0; i < w; i++) drawPixel(x + i, y + j, gradient565(&gr, x + i + _xDatum, yd, true));
+    }
+    gradientStep(&gr);
+  }
+}
+
+/***************************************************************************************
+** Function name:           fillRectHGradient
+** Description:             draw a filled rectangle with a horizontal colour gradient
+***************************************************************************************/
+void TFT_eSprite::fillRectHGradient(int16_t x, int16_t y, int16_t w, int16_t h, rgb_t color1, rgb_t color2)
+{
+  if (!_created || _vpOoB || (w < 1) || (h < 1)) return;
+
+  gradient_t gr;
+  gradientStart(&gr, color1, color2, w);
+
+  for (int32_t i = 0; i < w; i++) {
+    if (!_gradDither) drawFastVLine(x + i, y, h, gradient565(&gr, 0, 0, false));
+    else {
+      int32_t xd = x + i + _xDatum;
+      for (int32_t j = 0; j < h; j++) drawPixel(x + i, y + j, gradient565(&gr, xd, y + j + _yDatum, true));
+    }
+    gradientStep(&gr);
+  }
+}
+
+/***************************************************************************************
+** Function name:           fillGradient
+** Description:             fill a rectangle with a linear, radial or conic gradient
+***************************************************************************************/
+void TFT_eSprite::fillGradient(int32_t x, int32_t y, int32_t w, int32_t h, const gradfill_t *g)
+{
+  if (!_created || _vpOoB || (w < 1) || (h < 1)) return;
+
+  // Colours along the gradient
+  uint16_t ramp[256];
+  gradientRamp(ramp, g->color1, g->color2);
+
+  uint16_t lineBuf[w];
+  for (int32_t j = 0; j < h; j++) {
+    gradientLine(lineBuf, ramp, x, y + j, w, g);
+    for (int32_t i = 0; i < w; i++) drawPixel(x + i, y + j, lineBuf[i]);
+  }
+}
+
+/***************************************************************************************
+** Function name:           fillGradientSpans
+** Description:             fill spans with a gradient
+***************************************************************************************/
+void TFT_eSprite::fillGradientSpans(const span_t *spans, uint16_t n, const uint16_t *ramp, const gradfill_t *g)
+{
+  if (!_created || _vpOoB) return;
+
+  for (const span_t *s = spans; s < spans + n; s++) {
+    int32_t x = s->x;
+    int32_t w = s->w;
+
+    // Crop to the viewport so the line buffer stays small, drawPixel() clips the rest
+    if (x + _xDatum < _vpX) { w -= _vpX - x - _xDatum; x = _vpX - _xDatum; }
+    if (x + _xDatum + w > _vpW) w = _vpW - x - _xDatum;
+    if (w < 1) continue;
+
+    uint16_t lineBuf[w];
+    gradientLine(lineBuf, ramp, x, s->y, w, g);
+    for (int32_t i = 0; i < w; i++) drawPixel(x + i, s->y, lineBuf[i]);
+  }
+}
+
+/***************************************************************************************
+** Function name:           pushSpan
+** Description:             blend a run of anti-aliased pixels into the Sprite
+***************************************************************************************/
+void TFT_eSprite::pushSpan(int32_t x, int32_t y, rgb_t fg_color, rgb_t *bg, const uint8_t *alpha, int32_t len)
+{
+  blendSpan888(bg, fg_color, alpha, len);
+
+  // x,y have the datum added, drawPixel() adds it again
+  for (int32_t i = 0; i < len; i++) drawPixel(x + i - _xDatum, y - _yDatum, color24to16(bg[i]));
+}
+
 /***************************************************************************************
 ** Function name:           fillRect
 ** Description:             draw a filled rectangle
@@ -1889,6 +2370,8 @@ void TFT_eSprite::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t
 
   if ((w < 1) || (h < 1)) return;
 
+  DIRTY_MARK(x, y, w, h);
+
   int32_t yp = _iwidth * y + x;
 
   if (_bpp == 16)
@@ -2096,6 +2579,9 @@ void TFT_eSprite::drawChar(int32_t x, int32_t y, uint16_t c, uint32_t color, uin
       }
 
       uint16_t hpc = 0; // Horizontal foreground pixel count
+      // Runs batched, spans at size 1, rectangles when scaled
+      union { span_t span[SPAN_BATCH]; rect_t rect[SPAN_BATCH]; } run;
+      uint16_t nr = 0;
       for(yy=0; yy<h; yy++) {
         for(xx=0; xx<w; xx++) {
           if(bit == 0) {
@@ -2105,8 +2591,8 @@ void TFT_eSprite::drawChar(int32_t x, int32_t y, uint16_t c, uint32_t color, uin
           if(bits & bit) hpc++;
           else {
             if (hpc) {
-              if(size == 1) drawFastHLine(x+xo+xx-hpc, y+yo+yy, hpc, color);
-              else fillRect(x+(xo16+xx-hpc)*size, y+(yo16+yy)*size, size*hpc, size, color);
+              if(size == 1) addSpan(run.span, &nr, x+xo+xx-hpc, y+yo+yy, hpc, color);
+              else addRect(run.rect, &nr, x+(xo16+xx-hpc)*size, y+(yo16+yy)*size, size*hpc, size, color);
               hpc=0;
             }
           }
@@ -2114,11 +2600,15 @@ void TFT_eSprite::drawChar(int32_t x, int32_t y, uint16_t c, uint32_t color, uin
         }
         // Draw pixels for this line as we are about to increment yy
         if (hpc) {
-          if(size == 1) drawFastHLine(x+xo+xx-hpc, y+yo+yy, hpc, color);
-          else fillRect(x+(xo16+xx-hpc)*size, y+(yo16+yy)*size, size*hpc, size, color);
+          if(size == 1) addSpan(run.span, &nr, x+xo+xx-hpc, y+yo+yy, hpc, color);
+          else addRect(run.rect, &nr, x+(xo16+xx-hpc)*size, y+(yo16+yy)*size, size*hpc, size, color);
           hpc=0;
         }
       }
+      if (nr) {
+        if(size == 1) fillSpans(run.span, nr, color);
+        else fillRects(run.rect, nr, color);
+      }
     }
 #endif
 
@@ -2192,7 +2682,7 @@ int16_t TFT_eSprite::drawChar(uint16_t uniCode, int32_t x, int32_t y, uint8_t fo
 
   int32_t width  = 0;
   int32_t height = 0;
-  uint32_t flash_address = 0;
+  uintptr_t flash_address = 0;
   uniCode -= 32;
 
 #ifdef LOAD_FONT2
@@ -2408,6 +2898,50 @@ int16_t TFT_eSprite::drawChar(uint16_t uniCode, int32_t x, int32_t y, uint8_t fo
 
 
 #ifdef SMOOTH_FONT
+/***************************************************************************************
+** Function name:           glyphRun
+** Description:             Draw a run of anti-aliased glyph pixels
+***************************************************************************************/
+void TFT_eSprite::glyphRun(int32_t x, int32_t y, uint16_t fg, uint16_t bg, bool getBG, const uint8_t *alpha, int32_t len, bool solid)
+{
+  if (solid) {
+    if (len == 1) drawPixel(x, y, fg);
+    else drawFastHLine(x, y, len, fg);
+    return;
+  }
+
+  if (_bpp != 16) {
+    for (int32_t i = 0; i < len; i++) {
+      if (alpha[i] == 0xFF) drawPixel(x + i, y, fg);
+      else {
+        if (getBG) bg = readPixel(x + i, y);
+        drawPixel(x + i, y, alphaBlend(alpha[i], fg, bg));
+      }
+    }
+    return;
+  }
+
+  if (_vpOoB || !_created) return;
+
+  x+= _xDatum;
+  y+= _yDatum;
+
+  if ((y < _vpY) || (y >= _vpH)) return;
+  if (x < _vpX) { alpha += _vpX - x; len -= _vpX - x; x = _vpX; }
+  if (x + len > _vpW) len = _vpW - x;
+  if (len < 1) return;
+
+  DIRTY_MARK(x, y, len, 1);
+
+  // The Sprite holds the colours high byte first
+  uint16_t line[len];
+  uint16_t *p = _img + x + y * _iwidth;
+  for (int32_t i = 0; i < len; i++) line[i] = getBG ? (uint16_t)(p[i] >> 8 | p[i] << 8) : bg;
+  blendSpan565(line, fg, alpha, len);
+  for (int32_t i = 0; i < len; i++) p[i] = line[i] >> 8 | line[i] << 8;
+}
+
+
 /***************************************************************************************
 ** Function name:           drawGlyph
 ** Description:             Write a character to the sprite cursor position
@@ -2495,11 +3029,15 @@ void TFT_eSprite::drawGlyph(uint16_t code)
 
     int16_t  fxs = cx;
     uint32_t fl = 0;
+    bool     solid = true; // Every pixel of the run is 0xFF
     int16_t  bxs = cx;
     uint32_t bl = 0;
     int16_t  bx = 0;
     uint8_t pixel = 0;
 
+    // A run of inked pixels, blended in one span
+    uint8_t alpha[gWidth[gNum] + 1];
+
     int16_t fillwidth  = 0;
     int16_t fillheight = 0;
 
@@ -2546,25 +3084,13 @@ void TFT_eSprite::drawGlyph(uint16_t code)
         if (pixel)
         {
           if (bl) { drawFastHLine( bxs, y + cy, bl, bg); bl = 0; }
-          if (pixel != 0xFF)
-          {
-            if (fl) {
-              if (fl==1) drawPixel(fxs, y + cy, fg);
-              else drawFastHLine( fxs, y + cy, fl, fg);
-              fl = 0;
-            }
-            if (getBG) bg = readPixel(x + cx, y + cy);
-            drawPixel(x + cx, y + cy, alphaBlend(pixel, fg, bg));
-          }
-          else
-          {
-            if (fl==0) fxs = x + cx;
-            fl++;
-          }
+          if (fl==0) { fxs = x + cx; solid = true; }
+          if (pixel != 0xFF) solid = false;
+          alpha[fl++] = pixel;
         }
         else
         {
-          if (fl) { drawFastHLine( fxs, y + cy, fl, fg); fl = 0; }
+          if (fl) { glyphRun(fxs, y + cy, fg, bg, getBG, alpha, fl, solid); fl = 0; }
           if (_fillbg) {
             if (x >= bx) {
               if (bl==0) bxs = x + cx;
@@ -2573,7 +3099,7 @@ void TFT_eSprite::drawGlyph(uint16_t code)
           }
         }
       }
-      if (fl) { drawFastHLine( fxs, y + cy, fl, fg); fl = 0; }
+      if (fl) { glyphRun(fxs, y + cy, fg, bg, getBG, alpha, fl, solid); fl = 0; }
       if (bl) { drawFastHLine( bxs, y + cy, bl, bg); bl = 0; }
     }
 
@@ -5,6 +5,26 @@
 // graphics are written to the Sprite rather than the TFT.
 ***************************************************************************************/
 
+// Written areas tracked for pushDirty(), define SPRITE_DIRTY to enable. Every write
+// to a Sprite then marks its area.
+#ifdef SPRITE_DIRTY
+  // Number of rectangles the written areas are merged into
+  #ifndef SPRITE_DIRTY_RECTS
+    #define SPRITE_DIRTY_RECTS 8
+  #endif
+
+  #define DIRTY_MARK(x, y, w, h)  markDirty(x, y, w, h)
+  #define DIRTY_CLEAR()           _dirtyCount = 0
+#else
+  #define DIRTY_MARK(x, y, w, h)
+  #define DIRTY_CLEAR()
+#endif
+
+// Changed runs closer than this many pixels are pushed by pushDiff() as one
+#ifndef SPRITE_DIFF_GAP
+  #define SPRITE_DIFF_GAP 8
+#endif
+
 class TFT_eSprite : public TFT_eSPI {
 
  public:
@@ -85,7 +105,15 @@ class TFT_eSprite : public TFT_eSPI {
            drawFastHLine(int32_t x, int32_t y, int32_t w, rgb_t color),
 
            // Fill a rectangular area with a color (aka draw a filled rectangle)
-           fillRect(int32_t x, int32_t y, int32_t w, int32_t h, rgb_t color);
+           fillRect(int32_t x, int32_t y, int32_t w, int32_t h, rgb_t color),
+
+           // Fill n spans or rectangles, the colour is converted once for the batch
+           fillSpans(const span_t *spans, uint16_t n, rgb_t color),
+           fillRects(const rect_t *rects, uint16_t n, rgb_t color),
+
+           // Gradients drawn into the Sprite, see TFT_GFX
+           fillRectVGradient(int16_t x, int16_t y, int16_t w, int16_t h, rgb_t color1, rgb_t color2),
+           fillRectHGradient(int16_t x, int16_t y, int16_t w, int16_t h, rgb_t color1, rgb_t color2);
 
            // Set the coordinate rotation of the Sprite (for 1bpp Sprites only)
            // Note: this uses coordinate rotation and is primarily for ePaper which does not support
@@ -109,6 +137,8 @@ class TFT_eSprite : public TFT_eSPI {
 
            // Read the colour of a pixel at x,y and return value in 565 format
   rgb_t    readPixel(int32_t x0, int32_t y0) override;
+           // Read a rectangle of the Sprite as 565 pixels, see TFT_eeSPI
+  void     readRect(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *data) override;
 
            // return the numerical value of the pixel at x,y (used when scrolling)
            // 16bpp = colour, 8bpp = byte, 4bpp = colour index, 1bpp = 1 or 0
@@ -126,6 +156,34 @@ class TFT_eSprite : public TFT_eSPI {
            // Push a windowed area of the sprite to the TFT at tx, ty
   bool     pushSprite(int32_t tx, int32_t ty, int32_t sx, int32_t sy, int32_t sw, int32_t sh);
 
+           // Scene drawn into a band by pushBanded(), in coordinates relative to the
+           // top left corner of the scene, checkViewport() tells if an area is in the band
+  typedef void (*bandScene_t)(TFT_eSprite *band, void *param);
+
+           // Render a scene of sprite width x h pixels at tx, ty through this sprite used
+           // as a band buffer. The band is cleared to bg, drawn by the scene and pushed
+           // with one window, then it moves down until the whole scene is done.
+  bool     pushBanded(int32_t tx, int32_t ty, int32_t h, bandScene_t scene, void *param = nullptr, rgb_t bg = TFT_BLACK);
+           // Draw rows by to by + h - 1 of a scene into the sprite cleared to bg, it is not pushed
+  bool     drawBand(int32_t by, int32_t h, bandScene_t scene, void *param = nullptr, rgb_t bg = TFT_BLACK);
+
+#ifdef SPRITE_DIRTY
+           // Areas written since the last pushDirty() are kept as a short list of merged
+           // rectangles in sprite coordinates, markDirty() adds an area written directly
+           // through getPointer()
+  void     markDirty(int32_t x, int32_t y, int32_t w, int32_t h);
+  void     clearDirty(void) { _dirtyCount = 0; }
+  uint8_t  getDirtyCount(void) { return _dirtyCount; }
+
+           // Push only the written areas to the TFT, sprite top left corner at x, y
+  void     pushDirty(int32_t x, int32_t y);
+#endif
+
+           // For a Sprite created with 2 frames, push only the pixels changed since the
+           // previous pushDiff(), then swap frames. Drawing continues on a copy of the
+           // pushed frame. Other Sprites are pushed whole.
+  void     pushDiff(int32_t x, int32_t y);
+
            // Push the sprite to another sprite at x,y. This fn calls pushImage() in the destination sprite (dspr) class.
   bool     pushToSprite(TFT_eSprite *dspr, int32_t x, int32_t y);
   bool     pushToSprite(TFT_eSprite *dspr, int32_t x, int32_t y, uint16_t transparent);
@@ -159,8 +217,17 @@ class TFT_eSprite : public TFT_eSPI {
   void     begin_nin_write(void) { ; }
   void     end_nin_write(void) { ; }
 
+           // Draw a run of glyph pixels over bg or what is there, blended as one span in 16 bpp
+  void     glyphRun(int32_t x, int32_t y, uint16_t fg, uint16_t bg, bool getBG, const uint8_t *alpha, int32_t len, bool solid);
+
  protected:
 
+           // Draw the linear, radial and conic gradients into the Sprite
+  void     fillGradient(int32_t x, int32_t y, int32_t w, int32_t h, const gradfill_t *g) override;
+  void     fillGradientSpans(const span_t *spans, uint16_t n, const uint16_t *ramp, const gradfill_t *g) override;
+           // Blend the anti-aliased runs into the Sprite, not the screen window
+  void     pushSpan(int32_t x, int32_t y, rgb_t fg_color, rgb_t *bg, const uint8_t *alpha, int32_t len) override;
+
   uint8_t  _bpp;     // bits per pixel (1, 4, 8 or 16)
   uint16_t *_img;    // pointer to 16-bit sprite
   uint8_t  *_img8;   // pointer to  1 and 8-bit sprite frame 1 or frame 2
@@ -185,4 +252,14 @@ class TFT_eSprite : public TFT_eSPI {
   int32_t  _dwidth, _dheight; // Real sprite width and height (for <8bpp Sprites)
   int32_t  _bitwidth;         // Sprite image bit width for drawPixel (for <8bpp Sprites, not swapped)
 
+#ifdef SPRITE_DIRTY
+  // Written areas, x1 and y1 are the end edges + 1
+  typedef struct { int16_t x0, y0, x1, y1; } dirty_rect_t;
+  dirty_rect_t _dirty[SPRITE_DIRTY_RECTS];
+  uint8_t  _dirtyCount = 0;
+  uint8_t  _dirtyLast = 0;     // Index of the rectangle the last write landed in
+#endif
+
+  bool     _diffValid = false; // The other frame holds what pushDiff() last sent
+
 };
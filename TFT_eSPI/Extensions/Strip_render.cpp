@@ -0,0 +1,167 @@
+ // This is the TFT_eStrips class, two core rendering through Sprite strips
+ // Loaded if STRIP_RENDER is defined by user
+
+#ifdef STRIP_CORE1_PICO
+std::atomic<TFT_eStrips *> TFT_eStrips::_active(nullptr);
+bool TFT_eStrips::_launched = false;
+#endif
+
+/***************************************************************************************
+** Function name:           TFT_eStrips
+** Description:             Class constructor
+***************************************************************************************/
+TFT_eStrips::TFT_eStrips(TFT_eSPI *tft)
+{
+  _tft = tft;
+  _count = 0;
+  _width = 0;
+  _lines = 0;
+  _scene = nullptr;
+  _param = nullptr;
+  _bg = TFT_BLACK;
+  _h = 0;
+  _head = 0;
+  _tail = 0;
+  for (uint8_t i = 0; i < STRIP_RING_MAX; i++) _strip[i] = nullptr;
+}
+
+/***************************************************************************************
+** Function name:           ~TFT_eStrips
+** Description:             Class destructor
+***************************************************************************************/
+TFT_eStrips::~TFT_eStrips(void)
+{
+  deleteStrips();
+}
+
+/***************************************************************************************
+** Function name:           createStrips
+** Description:             Create the ring of strip Sprites
+***************************************************************************************/
+bool TFT_eStrips::createStrips(int16_t width, int16_t lines, uint8_t count)
+{
+  deleteStrips();
+
+  if (count < 2) count = 2;
+  if (count > STRIP_RING_MAX) count = STRIP_RING_MAX;
+
+  for (uint8_t i = 0; i < count; i++) {
+    _strip[i] = new TFT_eSprite(_tft);
+    _strip[i]->setColorDepth(16);
+    _count = i + 1;
+    if (!_strip[i]->createSprite(width, lines)) {
+      deleteStrips();
+      return false;
+    }
+  }
+
+  _width = width;
+  _lines = lines;
+  return true;
+}
+
+/***************************************************************************************
+** Function name:           deleteStrips
+** Description:             Free the strip Sprites
+***************************************************************************************/
+void TFT_eStrips::deleteStrips(void)
+{
+  for (uint8_t i = 0; i < _count; i++) {
+    delete _strip[i]; // The destructor frees the Sprite RAM
+    _strip[i] = nullptr;
+  }
+  _count = 0;
+}
+
+/***************************************************************************************
+** Function name:           produce
+** Description:             Draw the strips of the scene into the ring
+***************************************************************************************/
+void TFT_eStrips::produce(void)
+{
+  uint32_t n = (_h + _lines - 1) / _lines;
+
+  for (uint32_t i = 0; i < n; i++) {
+    // Wait for the strip drawn count strips ago to be pushed
+    while (i - _tail.load(std::memory_order_acquire) >= _count) STRIP_IDLE();
+
+    int32_t by = i * _lines;
+    int32_t bh = _h - by;
+    if (bh > _lines) bh = _lines;
+    _strip[i % _count]->drawBand(by, bh, _scene, _param, _bg);
+
+    _head.store(i + 1, std::memory_order_release);
+  }
+}
+
+#ifdef STRIP_CORE1_PICO
+/***************************************************************************************
+** Function name:           core1Entry
+** Description:             Core 1 runs the producer of each render(), never returns
+***************************************************************************************/
+void TFT_eStrips::core1Entry(void)
+{
+  while (1) {
+    TFT_eStrips *strips;
+    while ((strips = _active.load(std::memory_order_acquire)) == nullptr) STRIP_IDLE();
+    strips->produce();
+    _active.store(nullptr, std::memory_order_release);
+  }
+}
+#endif
+
+/***************************************************************************************
+** Function name:           render
+** Description:             Draw the strips on the other core and push them on this one
+***************************************************************************************/
+bool TFT_eStrips::render(int32_t tx, int32_t ty, int32_t h, TFT_eSprite::bandScene_t scene, void *param, rgb_t bg)
+{
+  if (!_count || !scene || h < 1) return false;
+
+  _scene = scene;
+  _param = param;
+  _bg = bg;
+  _h = h;
+  _head.store(0, std::memory_order_relaxed);
+  _tail.store(0, std::memory_order_relaxed);
+
+  uint32_t n = (h + _lines - 1) / _lines;
+
+#if defined(STRIP_CORE1_PICO)
+  _active.store(this, std::memory_order_release);
+  if (!_launched) {
+    multicore_launch_core1(core1Entry);
+    _launched = true;
+  }
+#elif defined(STRIP_CORE1_THREAD)
+  std::thread core1(&TFT_eStrips::produce, this);
+#endif
+
+  _tft->startWrite();
+  for (uint32_t i = 0; i < n; i++) {
+    int32_t by = i * _lines;
+    int32_t bh = h - by;
+    if (bh > _lines) bh = _lines;
+
+#if defined(STRIP_CORE1_PICO) || defined(STRIP_CORE1_THREAD)
+    while (_head.load(std::memory_order_acquire) <= i) STRIP_IDLE();
+#else
+    // One core, draw the strip here
+    _strip[i % _count]->drawBand(by, bh, scene, param, bg);
+#endif
+
+    _strip[i % _count]->pushSprite(tx, ty + by, 0, 0, _width, bh);
+
+    _tail.store(i + 1, std::memory_order_release);
+  }
+  _tft->endWrite();
+
+#if defined(STRIP_CORE1_THREAD)
+  core1.join();
+#elif defined(STRIP_CORE1_PICO)
+  // Core 1 is idle again once it has released the render
+  while (_active.load(std::memory_order_acquire) != nullptr) STRIP_IDLE();
+#endif
+
+  return true;
+}
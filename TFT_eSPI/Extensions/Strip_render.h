@@ -0,0 +1,82 @@
+/***************************************************************************************
+// The following class renders a scene through a ring of Sprite strips using two cores,
+// the strips are drawn on core 1 (a thread on the host) while the core calling render()
+// pushes the finished ones to the TFT. Loaded if STRIP_RENDER is defined by user.
+// On the RP2040 core 1 is only used if STRIP_CORE1 is also defined (link pico_multicore),
+// the strip worker is then launched on the first render() and keeps core 1.
+***************************************************************************************/
+
+#include <atomic>
+
+// Core 1 of the RP2040, or a thread where there are threads, otherwise one core does both
+#if defined(STRIP_CORE1) && (defined(LIB_PICO_MULTICORE) || defined(ARDUINO_ARCH_RP2040))
+  #include <pico/multicore.h>
+  #define STRIP_CORE1_PICO
+  #define STRIP_IDLE() tight_loop_contents()
+#elif defined(__linux__) || defined(__APPLE__) || defined(_WIN32)
+  // env.h min and max macros break the standard headers
+  #pragma push_macro("min")
+  #pragma push_macro("max")
+  #undef min
+  #undef max
+  #include <thread>
+  #pragma pop_macro("max")
+  #pragma pop_macro("min")
+  #define STRIP_CORE1_THREAD
+  #define STRIP_IDLE() std::this_thread::yield()
+#else
+  #define STRIP_IDLE()
+#endif
+
+// Most strips in the ring
+#ifndef STRIP_RING_MAX
+  #define STRIP_RING_MAX 4
+#endif
+
+class TFT_eStrips {
+
+ public:
+
+  explicit TFT_eStrips(TFT_eSPI *tft);
+  ~TFT_eStrips(void);
+
+           // Create a ring of count (2 to STRIP_RING_MAX) 16 bpp strips of width x lines
+           // pixels, return false if the RAM is not available
+  bool     createStrips(int16_t width, int16_t lines, uint8_t count = 2);
+  void     deleteStrips(void);
+
+           // Render a scene of strip width x h pixels at tx, ty, see TFT_eSprite::drawBand().
+           // The scene runs on the other core, it must only draw into the strip it is given.
+           // With STRIP_CORE1 on the RP2040 core 1 must be free, it is launched once and then
+           // waits for the next render().
+           // Bus statistics are not attributed reliably while both cores draw.
+  bool     render(int32_t tx, int32_t ty, int32_t h, TFT_eSprite::bandScene_t scene,
+                  void *param = nullptr, rgb_t bg = TFT_BLACK);
+
+ private:
+
+  TFT_eSPI    *_tft;
+  TFT_eSprite *_strip[STRIP_RING_MAX];
+  uint8_t      _count;
+  int16_t      _width, _lines;
+
+  // Scene of the render() in progress
+  TFT_eSprite::bandScene_t _scene;
+  void        *_param;
+  rgb_t        _bg;
+  int32_t      _h;
+
+  // Single producer, single consumer ring: strip i is drawn in _strip[i % _count] once
+  // i - _tail < _count, and pushed once i < _head. Each index is written by one side only.
+  std::atomic<uint32_t> _head;
+  std::atomic<uint32_t> _tail;
+
+           // Draw all the strips of the scene, runs on the other core
+  void     produce(void);
+
+#ifdef STRIP_CORE1_PICO
+  static std::atomic<TFT_eStrips *> _active;
+  static bool _launched;
+  static void core1Entry(void);
+#endif
+};
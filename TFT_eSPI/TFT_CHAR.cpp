@@ -34,17 +34,33 @@
 ***************************************************************************************/
 inline void pushBlock(rgb_t color, int32_t len)
 {
+  SHADOW_FILL(color, len);
+  SHADOW_DEFER();
+  BUS_STATS_PIXELS(len);
+  WINDOW_PIXELS(len);
   tft_sendMDTColor(mdt_color(color), len);
 }
 
+/***************************************************************************************
+** Function name:           pushPixel
+** Description:             send one pixel of a character at the write pointer
+***************************************************************************************/
+inline void pushPixel(rgb_t color, mdt_t mdt)
+{
+  SHADOW_FILL(color, 1);
+  SHADOW_DEFER();
+  tft_sendMDTColor(mdt);
+}
+
 
 /***************************************************************************************
 ** Function name:           begin_tft_write (was called spi_begin)
 ** Description:             Start SPI transaction for writes and select TFT
 ***************************************************************************************/
 inline void TFT_eeSPI::begin_tft_write(void){
-  if (locked) {
+  if (locked && !SHADOW_DEFERRED()) { // No transaction while nothing is sent
     locked = false; // Flag to show SPI access now unlocked
+    BUS_STATS_TRANSACTION();
     tft_startWrite();
   }
 }
@@ -56,8 +72,12 @@ inline void TFT_eeSPI::begin_tft_write(void){
 inline void TFT_eeSPI::end_tft_write(void){
   if(!inTransaction) {      // Flag to stop ending transaction during multiple graphics calls
     if (!locked) {          // Locked when beginTransaction has been called
+#ifdef TFT_AUTO_BATCH
+      batchTime = micros(); // Left open for the next call, see endBatch()
+#else
       locked = true;        // Flag to show SPI access now locked
       tft_endWrite();
+#endif
     }
   }
 }
@@ -226,6 +246,7 @@ int16_t TFT_CHAR::fontHeight(void)
 ***************************************************************************************/
 void TFT_CHAR::drawChar(int32_t x, int32_t y, uint16_t c, rgb_t color, rgb_t bg, uint8_t size)
 {
+  BUS_STATS_API(BUS_API_DRAWCHAR);
   if (_vpOoB) return;
 
 #ifdef LOAD_GLCD
@@ -256,6 +277,10 @@ void TFT_CHAR::drawChar(int32_t x, int32_t y, uint16_t c, rgb_t color, rgb_t bg,
     begin_tft_write();
 
     setWindow(xd, yd, xd+5, yd+7);
+    if (!SHADOW_DEFERRED()) {
+      BUS_STATS_PIXELS(48);
+      WINDOW_PIXELS(48);
+    }
 
     for (int8_t i = 0; i < 5; i++ ) column[i] = pgm_read_byte(&font[0] + (c * 5) + i);
     column[5] = 0;
@@ -265,11 +290,11 @@ void TFT_CHAR::drawChar(int32_t x, int32_t y, uint16_t c, rgb_t color, rgb_t bg,
 
     for (int8_t j = 0; j < 8; j++) {
       for (int8_t k = 0; k < 5; k++ ) {
-        if (column[k] & mask) {tft_sendMDTColor(mdt_co);}
-        else {tft_sendMDTColor(mdt_bg);}
+        if (column[k] & mask) pushPixel(color, mdt_co);
+        else pushPixel(bg, mdt_bg);
       }
       mask <<= 1;
-      tft_sendMDTColor(mdt_bg);
+      pushPixel(bg, mdt_bg);
     }
 
     end_tft_write();
@@ -337,6 +362,9 @@ void TFT_CHAR::drawChar(int32_t x, int32_t y, uint16_t c, rgb_t color, rgb_t bg,
 
       // GFXFF rendering speed up
       uint16_t hpc = 0; // Horizontal foreground pixel count
+      // Runs batched, spans at size 1, rectangles when scaled
+      union { span_t span[SPAN_BATCH]; rect_t rect[SPAN_BATCH]; } run;
+      uint16_t nr = 0;
       for(yy=0; yy<h; yy++) {
         for(xx=0; xx<w; xx++) {
           if(bit == 0) {
@@ -346,8 +374,8 @@ void TFT_CHAR::drawChar(int32_t x, int32_t y, uint16_t c, rgb_t color, rgb_t bg,
           if(bits & bit) hpc++;
           else {
            if (hpc) {
-              if(size == 1) drawFastHLine(x+xo+xx-hpc, y+yo+yy, hpc, color);
-              else fillRect(x+(xo16+xx-hpc)*size, y+(yo16+yy)*size, size*hpc, size, color);
+              if(size == 1) addSpan(run.span, &nr, x+xo+xx-hpc, y+yo+yy, hpc, color);
+              else addRect(run.rect, &nr, x+(xo16+xx-hpc)*size, y+(yo16+yy)*size, size*hpc, size, color);
               hpc=0;
             }
           }
@@ -355,11 +383,15 @@ void TFT_CHAR::drawChar(int32_t x, int32_t y, uint16_t c, rgb_t color, rgb_t bg,
         }
         // Draw pixels for this line as we are about to increment yy
         if (hpc) {
-          if(size == 1) drawFastHLine(x+xo+xx-hpc, y+yo+yy, hpc, color);
-          else fillRect(x+(xo16+xx-hpc)*size, y+(yo16+yy)*size, size*hpc, size, color);
+          if(size == 1) addSpan(run.span, &nr, x+xo+xx-hpc, y+yo+yy, hpc, color);
+          else addRect(run.rect, &nr, x+(xo16+xx-hpc)*size, y+(yo16+yy)*size, size*hpc, size, color);
           hpc=0;
         }
       }
+      if (nr) {
+        if(size == 1) fillSpans(run.span, nr, color);
+        else fillRects(run.rect, nr, color);
+      }
 
       inTransaction = lockTransaction;
       end_tft_write();              // Does nothing if Sprite class uses this function
@@ -620,12 +652,14 @@ size_t TFT_CHAR::write(uint8_t utf8)
   // Any UTF-8 decoding must be done before calling drawChar()
 int16_t TFT_CHAR::drawChar(uint16_t uniCode, int32_t x, int32_t y)
 {
+  BUS_STATS_API(BUS_API_DRAWCHAR);
   return drawChar(uniCode, x, y, textfont);
 }
 
   // Any UTF-8 decoding must be done before calling drawChar()
 int16_t TFT_CHAR::drawChar(uint16_t uniCode, int32_t x, int32_t y, uint8_t font)
 {
+  BUS_STATS_API(BUS_API_DRAWCHAR);
   if (_vpOoB || !uniCode) return 0;
 
   if (font==1) {
@@ -666,7 +700,7 @@ int16_t TFT_CHAR::drawChar(uint16_t uniCode, int32_t x, int32_t y, uint8_t font)
 
   int32_t width  = 0;
   int32_t height = 0;
-  uint32_t flash_address = 0;
+  uintptr_t flash_address = 0;
   uniCode -= 32;
 
 #ifdef LOAD_FONT2
@@ -751,6 +785,10 @@ int16_t TFT_CHAR::drawChar(uint16_t uniCode, int32_t x, int32_t y, uint8_t font)
       begin_tft_write();
 
       setWindow(xd, yd, xd + width - 1, yd + height - 1);
+      if (!SHADOW_DEFERRED()) {
+        BUS_STATS_PIXELS(width * height);
+        WINDOW_PIXELS(width * height);
+      }
 
       mdt_t mdt_textcolor = mdt_color(textcolor);
       mdt_t mdt_textbgcolor = mdt_color(textbgcolor);
@@ -762,13 +800,13 @@ int16_t TFT_CHAR::drawChar(uint16_t uniCode, int32_t x, int32_t y, uint8_t font)
           line = pgm_read_byte((uint8_t *) (flash_address + w * i + k) );
           mask = 0x80;
           while (mask && pX) {
-            if (line & mask) {tft_sendMDTColor(mdt_textcolor);}
-            else {tft_sendMDTColor(mdt_textbgcolor);}
+            if (line & mask) pushPixel(textcolor, mdt_textcolor);
+            else pushPixel(textbgcolor, mdt_textbgcolor);
             pX--;
             mask = mask >> 1;
           }
         }
-        if (pX) {tft_sendMDTColor(mdt_textbgcolor);}
+        if (pX) pushPixel(textbgcolor, mdt_textbgcolor);
       }
 
       end_tft_write();
@@ -824,10 +862,14 @@ int16_t TFT_CHAR::drawChar(uint16_t uniCode, int32_t x, int32_t y, uint8_t font)
                 tft_sendMDTColor(mdt_textcolor);
               }
 */
-              tft_sendMDTColor(mdt_textcolor, np);
+              pushBlock(textcolor, np);
             }
             else {
-              tft_sendMDTColor(mdt_textcolor);
+              if (!SHADOW_DEFERRED()) {
+                BUS_STATS_PIXELS(1);
+                WINDOW_PIXELS(1);
+              }
+              pushPixel(textcolor, mdt_textcolor);
             }
             px += textsize;
 
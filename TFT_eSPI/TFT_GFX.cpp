@@ -27,6 +27,8 @@
 
 #include "TFT_GFX.h"
 #include <TFT_API.h>
+#include <string.h>
+#include <stdlib.h>
 
 /***************************************************************************************
 ** Function name:           pushBlock
@@ -34,9 +36,113 @@
 ***************************************************************************************/
 inline void pushBlock(rgb_t color, int32_t len)
 {
+  SHADOW_FILL(color, len);
+  SHADOW_DEFER();
+  BUS_STATS_PIXELS(len);
+  WINDOW_PIXELS(len);
   tft_sendMDTColor(mdt_color(color), len);
 }
 
+// Indexed pushImage conversion tables, built on first use and rebuilt when the palette
+// or the bitmap colours change. Entries are 565 as pushPixels() takes them, see wire565().
+static uint16_t lut332[256];     // 8bpp 332 colour to 565
+static bool     lut332Valid = false;
+static uint32_t lut4[256];       // 4bpp byte to its two pixels
+static uint16_t lut4Pal[16];     // 4bpp index to pixel
+static uint16_t lut4Map[16];     // Palette lut4 was built from
+static bool     lut4Valid = false;
+static uint16_t lut1[256 * 8];   // 1bpp byte to its eight pixels
+static uint16_t lut1Fg, lut1Bg;  // 565 colours lut1 was built from
+static bool     lut1Valid = false;
+
+// 565 colour in pushPixels() order, high byte first in memory on a 565 bus,
+// native on a 666 one where pushPixels() expands each 565 value
+static inline uint16_t wire565(uint16_t c)
+{
+#if defined(COLOR_565)
+  uint8_t b[2] = { (uint8_t)(c >> 8), (uint8_t)c };
+  memcpy(&c, b, 2);
+#endif
+  return c;
+}
+
+static void getLut332(void)
+{
+  if (lut332Valid) return;
+
+  uint8_t  blue[] = {0, 11, 21, 31}; // blue 2 to 5-bit colour lookup table
+
+  for (uint16_t c = 0; c < 256; c++) {
+    //          =====Green=====     ===============Red==============
+    uint8_t msb = (c & 0x1C)>>2 | (c & 0xC0)>>3 | (c & 0xE0);
+    //          =====Green=====    =======Blue======
+    uint8_t lsb = (c & 0x1C)<<3 | blue[c & 0x03];
+    lut332[c] = wire565(msb << 8 | lsb);
+  }
+  lut332Valid = true;
+}
+
+static void getLut4(const uint16_t* cmap)
+{
+  if (lut4Valid && !memcmp(lut4Map, cmap, sizeof(lut4Map))) return;
+
+  memcpy(lut4Map, cmap, sizeof(lut4Map));
+  for (uint8_t i = 0; i < 16; i++) lut4Pal[i] = wire565(cmap[i]);
+
+  // Even pixel in bits 7..4, odd pixel in bits 3..0
+  for (uint16_t c = 0; c < 256; c++) {
+    uint16_t px[2] = { lut4Pal[c >> 4], lut4Pal[c & 0x0F] };
+    memcpy(&lut4[c], px, 4);
+  }
+  lut4Valid = true;
+}
+
+static void getLut1(uint16_t fg, uint16_t bg)
+{
+  if (lut1Valid && lut1Fg == fg && lut1Bg == bg) return;
+
+  lut1Fg = fg;
+  lut1Bg = bg;
+  fg = wire565(fg);
+  bg = wire565(bg);
+
+  // Leftmost pixel in bit 7
+  uint16_t* p = lut1;
+  for (uint16_t c = 0; c < 256; c++) {
+    for (uint8_t mask = 0x80; mask; mask >>= 1) *p++ = (c & mask) ? fg : bg;
+  }
+  lut1Valid = true;
+}
+
+// Convert a line of n 8bpp pixels
+static inline void line332(uint16_t* out, const uint8_t* p, int32_t n)
+{
+  while (n--) *out++ = lut332[pgm_read_byte(p++)];
+}
+
+// Convert a line of n 4bpp pixels, p points to the byte of the first, odd if first is set
+static inline void line4(uint16_t* out, const uint8_t* p, bool odd, int32_t n)
+{
+  if (odd && n) { *out++ = lut4Pal[pgm_read_byte(p++) & 0x0F]; n--; }
+  while (n > 1) { memcpy(out, &lut4[pgm_read_byte(p++)], 4); out += 2; n -= 2; }
+  if (n) *out = lut4Pal[pgm_read_byte(p) >> 4];
+}
+
+// Convert a line of n 1bpp pixels starting at bit x
+static inline void line1(uint16_t* out, const uint8_t* p, int32_t x, int32_t n)
+{
+  p += x >> 3;
+  int32_t bit = x & 7;
+  while (n > 0) {
+    int32_t k = 8 - bit;
+    if (k > n) k = n;
+    memcpy(out, &lut1[(pgm_read_byte(p++) << 3) + bit], k * 2);
+    out += k;
+    n -= k;
+    bit = 0;
+  }
+}
+
 // Clipping macro for pushImage
 #define PI_CLIP                                        \
   if (_vpOoB) return;                                  \
@@ -63,8 +169,9 @@ inline void pushBlock(rgb_t color, int32_t len)
 ** Description:             Start SPI transaction for writes and select TFT
 ***************************************************************************************/
 inline void TFT_eeSPI::begin_tft_write(void){
-  if (locked) {
+  if (locked && !SHADOW_DEFERRED()) { // No transaction while nothing is sent
     locked = false; // Flag to show SPI access now unlocked
+    BUS_STATS_TRANSACTION();
     tft_startWrite();
   }
 }
@@ -76,8 +183,12 @@ inline void TFT_eeSPI::begin_tft_write(void){
 inline void TFT_eeSPI::end_tft_write(void){
   if(!inTransaction) {      // Flag to stop ending transaction during multiple graphics calls
     if (!locked) {          // Locked when beginTransaction has been called
+#ifdef TFT_AUTO_BATCH
+      batchTime = micros(); // Left open for the next call, see endBatch()
+#else
       locked = true;        // Flag to show SPI access now locked
       tft_endWrite();
+#endif
     }
   }
 }
@@ -87,6 +198,7 @@ TFT_GFX::TFT_GFX() : TFT_eeSPI()
 {
   bitmap_fg = WHITE;
   bitmap_bg = BLACK;
+  _gradDither = false;
 }
 
 
@@ -96,6 +208,7 @@ TFT_GFX::TFT_GFX() : TFT_eeSPI()
 ***************************************************************************************/
 void TFT_GFX::pushRect(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *data)
 {
+  BUS_STATS_API(BUS_API_PUSHIMAGE);
   bool swap = _swapBytes; _swapBytes = false;
   pushImage(x, y, w, h, data);
   _swapBytes = swap;
@@ -108,6 +221,7 @@ void TFT_GFX::pushRect(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *dat
 ***************************************************************************************/
 void TFT_GFX::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *data)
 {
+  BUS_STATS_API(BUS_API_PUSHIMAGE);
   PI_CLIP;
 
   begin_tft_write();
@@ -138,6 +252,7 @@ void TFT_GFX::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *da
 ***************************************************************************************/
 void TFT_GFX::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *data, uint16_t transp)
 {
+  BUS_STATS_API(BUS_API_PUSHIMAGE);
   PI_CLIP;
 
   begin_tft_write();
@@ -197,6 +312,7 @@ void TFT_GFX::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *da
 ***************************************************************************************/
 void TFT_GFX::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t *data)
 {
+  BUS_STATS_API(BUS_API_PUSHIMAGE);
   // Requires 32-bit aligned access, so use PROGMEM 16-bit word functions
   PI_CLIP;
 
@@ -205,17 +321,20 @@ void TFT_GFX::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16
 
   data += dx + dy * w;
 
-  uint16_t  buffer[dw];
+  // A line is converted while the one before is sent
+  uint32_t  lineMem[TFT_LINE_WORDS(dw)];
+  uint16_t* lineBuf = lineBuffers(lineMem, dw);
 
   setWindow(x, y, x + dw - 1, y + dh - 1);
 
   // Fill and send line buffers to TFT
   for (int32_t i = 0; i < dh; i++) {
     for (int32_t j = 0; j < dw; j++) {
-      buffer[j] = pgm_read_word(&data[i * w + j]);
+      lineBuf[j] = pgm_read_word(&data[i * w + j]);
     }
-    pushPixels(buffer, dw);
+    lineBuf = pushLineBuffered(lineBuf, dw);
   }
+  pushPixelsWait();
 
   inTransaction = lockTransaction;
   end_tft_write();
@@ -227,6 +346,7 @@ void TFT_GFX::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16
 ***************************************************************************************/
 void TFT_GFX::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t *data, uint16_t transp)
 {
+  BUS_STATS_API(BUS_API_PUSHIMAGE);
   // Requires 32-bit aligned access, so use PROGMEM 16-bit word functions
   PI_CLIP;
 
@@ -283,128 +403,57 @@ void TFT_GFX::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16
 ***************************************************************************************/
 void TFT_GFX::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint8_t *data, bool bpp8,  uint16_t *cmap)
 {
+  BUS_STATS_API(BUS_API_PUSHIMAGE);
   PI_CLIP;
 
   begin_tft_write();
   inTransaction = true;
-  bool swap = _swapBytes;
 
   setWindow(x, y, x + dw - 1, y + dh - 1); // Sets CS low and sent RAMWR
 
-  // Line buffer makes plotting faster
-  uint16_t  lineBuf[dw];
+  // A line is converted while the one before is sent
+  uint32_t  lineMem[TFT_LINE_WORDS(dw)];
+  uint16_t* lineBuf = lineBuffers(lineMem, dw);
 
   if (bpp8)
   {
-    _swapBytes = false;
-
-    uint8_t  blue[] = {0, 11, 21, 31}; // blue 2 to 5-bit colour lookup table
-
-    uint32_t _lastColor = -1; // Set to illegal value
-
-    // Used to store last shifted colour
-    uint8_t msbColor = 0;
-    uint8_t lsbColor = 0;
+    getLut332();
 
     data += dx + dy * w;
     while (dh--) {
-      uint32_t len = dw;
-      uint8_t* ptr = (uint8_t*)data;
-      uint8_t* linePtr = (uint8_t*)lineBuf;
-
-      while(len--) {
-        uint32_t color = pgm_read_byte(ptr++);
-
-        // Shifts are slow so check if colour has changed first
-        if (color != _lastColor) {
-          //          =====Green=====     ===============Red==============
-          msbColor = (color & 0x1C)>>2 | (color & 0xC0)>>3 | (color & 0xE0);
-          //          =====Green=====    =======Blue======
-          lsbColor = (color & 0x1C)<<3 | blue[color & 0x03];
-          _lastColor = color;
-        }
-
-       *linePtr++ = msbColor;
-       *linePtr++ = lsbColor;
-      }
-
-      pushPixels(lineBuf, dw);
-
+      line332(lineBuf, data, dw);
+      lineBuf = pushLineBuffered(lineBuf, dw);
       data += w;
     }
-    _swapBytes = swap; // Restore old value
   }
   else if (cmap != nullptr) // Must be 4bpp
   {
-    _swapBytes = true;
+    getLut4(cmap);
 
     w = (w+1) & 0xFFFE;   // if this is a sprite, w will already be even; this does no harm.
-    bool splitFirst = (dx & 0x01) != 0; // split first means we have to push a single px from the left of the sprite / image
-
-    if (splitFirst) {
-      data += ((dx - 1 + dy * w) >> 1);
-    }
-    else {
-      data += ((dx + dy * w) >> 1);
-    }
+    data += (dx + dy * w) >> 1;
 
     while (dh--) {
-      uint32_t len = dw;
-      uint8_t * ptr = (uint8_t*)data;
-      uint16_t *linePtr = lineBuf;
-      uint8_t colors; // two colors in one byte
-      uint16_t index;
-
-      if (splitFirst) {
-        colors = pgm_read_byte(ptr);
-        index = (colors & 0x0F);
-        *linePtr++ = cmap[index];
-        len--;
-        ptr++;
-      }
-
-      while (len--)
-      {
-        colors = pgm_read_byte(ptr);
-        index = ((colors & 0xF0) >> 4) & 0x0F;
-        *linePtr++ = cmap[index];
-
-        if (len--)
-        {
-          index = colors & 0x0F;
-          *linePtr++ = cmap[index];
-        } else {
-          break;  // nothing to do here
-        }
-
-        ptr++;
-      }
-
-      pushPixels(lineBuf, dw);
+      line4(lineBuf, data, dx & 1, dw);
+      lineBuf = pushLineBuffered(lineBuf, dw);
       data += (w >> 1);
     }
-    _swapBytes = swap; // Restore old value
   }
   else // Must be 1bpp
   {
-    _swapBytes = false;
-    uint8_t * ptr = (uint8_t*)data;
+    getLut1(color24to16(bitmap_fg), color24to16(bitmap_bg));
+
     uint32_t ww =  (w+7)>>3; // Width of source image line in bytes
-    for (int32_t yp = dy;  yp < dy + dh; yp++)
-    {
-      uint8_t* linePtr = (uint8_t*)lineBuf;
-      for (int32_t xp = dx; xp < dx + dw; xp++)
-      {
-        uint16_t col = (pgm_read_byte(ptr + (xp>>3)) & (0x80 >> (xp & 0x7)) );
-        if (col) {*linePtr++ = bitmap_fg>>8; *linePtr++ = (uint8_t) bitmap_fg;}
-        else     {*linePtr++ = bitmap_bg>>8; *linePtr++ = (uint8_t) bitmap_bg;}
-      }
-      ptr += ww;
-      pushPixels(lineBuf, dw);
+    data += dy * ww;
+    while (dh--) {
+      line1(lineBuf, data, dx, dw);
+      data += ww;
+      lineBuf = pushLineBuffered(lineBuf, dw);
     }
   }
 
-  _swapBytes = swap; // Restore old value
+  pushPixelsWait();
+
   inTransaction = lockTransaction;
   end_tft_write();
 }
@@ -416,128 +465,57 @@ void TFT_GFX::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint8_
 ***************************************************************************************/
 void TFT_GFX::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t *data, bool bpp8,  uint16_t *cmap)
 {
+  BUS_STATS_API(BUS_API_PUSHIMAGE);
   PI_CLIP;
 
   begin_tft_write();
   inTransaction = true;
-  bool swap = _swapBytes;
 
   setWindow(x, y, x + dw - 1, y + dh - 1); // Sets CS low and sent RAMWR
 
-  // Line buffer makes plotting faster
-  uint16_t  lineBuf[dw];
+  // A line is converted while the one before is sent
+  uint32_t  lineMem[TFT_LINE_WORDS(dw)];
+  uint16_t* lineBuf = lineBuffers(lineMem, dw);
 
   if (bpp8)
   {
-    _swapBytes = false;
-
-    uint8_t  blue[] = {0, 11, 21, 31}; // blue 2 to 5-bit colour lookup table
-
-    uint32_t _lastColor = -1; // Set to illegal value
-
-    // Used to store last shifted colour
-    uint8_t msbColor = 0;
-    uint8_t lsbColor = 0;
+    getLut332();
 
     data += dx + dy * w;
     while (dh--) {
-      uint32_t len = dw;
-      uint8_t* ptr = data;
-      uint8_t* linePtr = (uint8_t*)lineBuf;
-
-      while(len--) {
-        uint32_t color = *ptr++;
-
-        // Shifts are slow so check if colour has changed first
-        if (color != _lastColor) {
-          //          =====Green=====     ===============Red==============
-          msbColor = (color & 0x1C)>>2 | (color & 0xC0)>>3 | (color & 0xE0);
-          //          =====Green=====    =======Blue======
-          lsbColor = (color & 0x1C)<<3 | blue[color & 0x03];
-          _lastColor = color;
-        }
-
-       *linePtr++ = msbColor;
-       *linePtr++ = lsbColor;
-      }
-
-      pushPixels(lineBuf, dw);
-
+      line332(lineBuf, data, dw);
+      lineBuf = pushLineBuffered(lineBuf, dw);
       data += w;
     }
-    _swapBytes = swap; // Restore old value
   }
   else if (cmap != nullptr) // Must be 4bpp
   {
-    _swapBytes = true;
+    getLut4(cmap);
 
     w = (w+1) & 0xFFFE;   // if this is a sprite, w will already be even; this does no harm.
-    bool splitFirst = (dx & 0x01) != 0; // split first means we have to push a single px from the left of the sprite / image
-
-    if (splitFirst) {
-      data += ((dx - 1 + dy * w) >> 1);
-    }
-    else {
-      data += ((dx + dy * w) >> 1);
-    }
+    data += (dx + dy * w) >> 1;
 
     while (dh--) {
-      uint32_t len = dw;
-      uint8_t * ptr = data;
-      uint16_t *linePtr = lineBuf;
-      uint8_t colors; // two colors in one byte
-      uint16_t index;
-
-      if (splitFirst) {
-        colors = *ptr;
-        index = (colors & 0x0F);
-        *linePtr++ = cmap[index];
-        len--;
-        ptr++;
-      }
-
-      while (len--)
-      {
-        colors = *ptr;
-        index = ((colors & 0xF0) >> 4) & 0x0F;
-        *linePtr++ = cmap[index];
-
-        if (len--)
-        {
-          index = colors & 0x0F;
-          *linePtr++ = cmap[index];
-        } else {
-          break;  // nothing to do here
-        }
-
-        ptr++;
-      }
-
-      pushPixels(lineBuf, dw);
+      line4(lineBuf, data, dx & 1, dw);
+      lineBuf = pushLineBuffered(lineBuf, dw);
       data += (w >> 1);
     }
-    _swapBytes = swap; // Restore old value
   }
   else // Must be 1bpp
   {
-    _swapBytes = false;
+    getLut1(color24to16(bitmap_fg), color24to16(bitmap_bg));
 
     uint32_t ww =  (w+7)>>3; // Width of source image line in bytes
-    for (int32_t yp = dy;  yp < dy + dh; yp++)
-    {
-      uint8_t* linePtr = (uint8_t*)lineBuf;
-      for (int32_t xp = dx; xp < dx + dw; xp++)
-      {
-        uint16_t col = (data[(xp>>3)] & (0x80 >> (xp & 0x7)) );
-        if (col) {*linePtr++ = bitmap_fg>>8; *linePtr++ = (uint8_t) bitmap_fg;}
-        else     {*linePtr++ = bitmap_bg>>8; *linePtr++ = (uint8_t) bitmap_bg;}
-      }
+    data += dy * ww;
+    while (dh--) {
+      line1(lineBuf, data, dx, dw);
       data += ww;
-      pushPixels(lineBuf, dw);
+      lineBuf = pushLineBuffered(lineBuf, dw);
     }
   }
 
-  _swapBytes = swap; // Restore old value
+  pushPixelsWait();
+
   inTransaction = lockTransaction;
   end_tft_write();
 }
@@ -549,6 +527,7 @@ void TFT_GFX::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t *dat
 ***************************************************************************************/
 void TFT_GFX::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t *data, uint8_t transp, bool bpp8, uint16_t *cmap)
 {
+  BUS_STATS_API(BUS_API_PUSHIMAGE);
   PI_CLIP;
 
   begin_tft_write();
@@ -564,18 +543,12 @@ void TFT_GFX::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t *dat
 
     data += dx + dy * w;
 
-    uint8_t  blue[] = {0, 11, 21, 31}; // blue 2 to 5-bit colour lookup table
-
-    uint32_t _lastColor = -1; // Set to illegal value
-
-    // Used to store last shifted colour
-    uint8_t msbColor = 0;
-    uint8_t lsbColor = 0;
+    getLut332();
 
     while (dh--) {
       int32_t len = dw;
       uint8_t* ptr = data;
-      uint8_t* linePtr = (uint8_t*)lineBuf;
+      uint16_t* linePtr = lineBuf;
 
       int32_t px = x, sx = x;
       bool move = true;
@@ -584,18 +557,7 @@ void TFT_GFX::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t *dat
       while (len--) {
         if (transp != *ptr) {
           if (move) { move = false; sx = px; }
-          uint8_t color = *ptr;
-
-          // Shifts are slow so check if colour has changed first
-          if (color != _lastColor) {
-            //          =====Green=====     ===============Red==============
-            msbColor = (color & 0x1C)>>2 | (color & 0xC0)>>3 | (color & 0xE0);
-            //          =====Green=====    =======Blue======
-            lsbColor = (color & 0x1C)<<3 | blue[color & 0x03];
-            _lastColor = color;
-          }
-          *linePtr++ = msbColor;
-          *linePtr++ = lsbColor;
+          *linePtr++ = lut332[*ptr];
           np++;
         }
         else {
@@ -603,7 +565,7 @@ void TFT_GFX::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t *dat
           if (np) {
             setWindow(sx, y, sx + np - 1, y);
             pushPixels(lineBuf, np);
-            linePtr = (uint8_t*)lineBuf;
+            linePtr = lineBuf;
             np = 0;
           }
         }
@@ -618,7 +580,7 @@ void TFT_GFX::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t *dat
   }
   else if (cmap != nullptr) // 4bpp with color map
   {
-    _swapBytes = true;
+    getLut4(cmap);
 
     w = (w+1) & 0xFFFE; // here we try to recreate iwidth from dwidth.
     bool splitFirst = ((dx & 0x01) != 0);
@@ -643,7 +605,7 @@ void TFT_GFX::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t *dat
         index = (*ptr & 0x0F);  // odd = bits 3 .. 0
         if (index != transp) {
           move = false; sx = px;
-          lineBuf[np] = cmap[index];
+          lineBuf[np] = lut4Pal[index];
           np++;
         }
         px++; ptr++;
@@ -661,7 +623,7 @@ void TFT_GFX::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t *dat
           if (move) {
             move = false; sx = px;
           }
-          lineBuf[np] = cmap[index];
+          lineBuf[np] = lut4Pal[index];
           np++; // added a pixel
         }
         else {
@@ -681,7 +643,7 @@ void TFT_GFX::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t *dat
             if (move) {
               move = false; sx = px;
              }
-            lineBuf[np] = cmap[index];
+            lineBuf[np] = lut4Pal[index];
             np++;
           }
           else {
@@ -755,6 +717,7 @@ void TFT_GFX::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t *dat
 // Can be used with a 16bpp sprite and a 1bpp sprite for the mask
 void TFT_GFX::pushMaskedImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *img, uint8_t *mask)
 {
+  BUS_STATS_API(BUS_API_PUSHIMAGE);
   if (_vpOoB || w < 1 || h < 1) return;
 
   // To simplify mask handling the window clipping is done by the pushImage function
@@ -841,6 +804,7 @@ void TFT_GFX::pushMaskedImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16
 // Optimised midpoint circle algorithm
 void TFT_GFX::drawCircle(int32_t x0, int32_t y0, int32_t r, rgb_t color)
 {
+  BUS_STATS_API(BUS_API_CIRCLE);
   if ( r <= 0 ) return;
 
   //begin_tft_write();          // Sprite class can use this function, avoiding begin_tft_write()
@@ -909,6 +873,7 @@ void TFT_GFX::drawCircle(int32_t x0, int32_t y0, int32_t r, rgb_t color)
 ***************************************************************************************/
 void TFT_GFX::drawCircleHelper( int32_t x0, int32_t y0, int32_t rr, uint8_t cornername, rgb_t color)
 {
+  BUS_STATS_API(BUS_API_CIRCLE);
   if (rr <= 0) return;
   int32_t f     = 1 - rr;
   int32_t ddF_x = 1;
@@ -980,21 +945,25 @@ void TFT_GFX::drawCircleHelper( int32_t x0, int32_t y0, int32_t rr, uint8_t corn
 // Improved algorithm avoids repetition of lines
 void TFT_GFX::fillCircle(int32_t x0, int32_t y0, int32_t r, rgb_t color)
 {
+  BUS_STATS_API(BUS_API_CIRCLE);
   int32_t  x  = 0;
   int32_t  dx = 1;
   int32_t  dy = r+r;
   int32_t  p  = -(r>>1);
 
+  span_t   span[SPAN_BATCH];
+  uint16_t n  = 0;
+
   //begin_tft_write();          // Sprite class can use this function, avoiding begin_tft_write()
   inTransaction = true;
 
-  drawFastHLine(x0 - r, y0, dy+1, color);
+  addSpan(span, &n, x0 - r, y0, dy+1, color);
 
   while(x<r){
 
     if(p>=0) {
-      drawFastHLine(x0 - x, y0 + r, dx, color);
-      drawFastHLine(x0 - x, y0 - r, dx, color);
+      addSpan(span, &n, x0 - x, y0 + r, dx, color);
+      addSpan(span, &n, x0 - x, y0 - r, dx, color);
       dy-=2;
       p-=dy;
       r--;
@@ -1004,11 +973,13 @@ void TFT_GFX::fillCircle(int32_t x0, int32_t y0, int32_t r, rgb_t color)
     p+=dx;
     x++;
 
-    drawFastHLine(x0 - r, y0 + x, dy+1, color);
-    drawFastHLine(x0 - r, y0 - x, dy+1, color);
+    addSpan(span, &n, x0 - r, y0 + x, dy+1, color);
+    addSpan(span, &n, x0 - r, y0 - x, dy+1, color);
 
   }
 
+  if (n) fillSpans(span, n, color);
+
   inTransaction = lockTransaction;
   end_tft_write();              // Does nothing if Sprite class uses this function
 }
@@ -1020,17 +991,21 @@ void TFT_GFX::fillCircle(int32_t x0, int32_t y0, int32_t r, rgb_t color)
 // Support drawing roundrects, changed to horizontal lines (faster in sprites)
 void TFT_GFX::fillCircleHelper(int32_t x0, int32_t y0, int32_t r, uint8_t cornername, int32_t delta, rgb_t color)
 {
+  BUS_STATS_API(BUS_API_CIRCLE);
   int32_t f     = 1 - r;
   int32_t ddF_x = 1;
   int32_t ddF_y = -r - r;
   int32_t y     = 0;
 
+  span_t   span[SPAN_BATCH];
+  uint16_t n    = 0;
+
   delta++;
 
   while (y < r) {
     if (f >= 0) {
-      if (cornername & 0x1) drawFastHLine(x0 - y, y0 + r, y + y + delta, color);
-      if (cornername & 0x2) drawFastHLine(x0 - y, y0 - r, y + y + delta, color);
+      if (cornername & 0x1) addSpan(span, &n, x0 - y, y0 + r, y + y + delta, color);
+      if (cornername & 0x2) addSpan(span, &n, x0 - y, y0 - r, y + y + delta, color);
       r--;
       ddF_y += 2;
       f     += ddF_y;
@@ -1040,9 +1015,11 @@ void TFT_GFX::fillCircleHelper(int32_t x0, int32_t y0, int32_t r, uint8_t corner
     ddF_x += 2;
     f     += ddF_x;
 
-    if (cornername & 0x1) drawFastHLine(x0 - r, y0 + y, r + r + delta, color);
-    if (cornername & 0x2) drawFastHLine(x0 - r, y0 - y, r + r + delta, color);
+    if (cornername & 0x1) addSpan(span, &n, x0 - r, y0 + y, r + r + delta, color);
+    if (cornername & 0x2) addSpan(span, &n, x0 - r, y0 - y, r + r + delta, color);
   }
+
+  if (n) fillSpans(span, n, color);
 }
 
 
@@ -1052,6 +1029,7 @@ void TFT_GFX::fillCircleHelper(int32_t x0, int32_t y0, int32_t r, uint8_t corner
 ***************************************************************************************/
 void TFT_GFX::drawEllipse(int16_t x0, int16_t y0, int32_t rx, int32_t ry, rgb_t color)
 {
+  BUS_STATS_API(BUS_API_CIRCLE);
   if (rx<2) return;
   if (ry<2) return;
   int32_t x, y;
@@ -1104,6 +1082,7 @@ void TFT_GFX::drawEllipse(int16_t x0, int16_t y0, int32_t rx, int32_t ry, rgb_t
 ***************************************************************************************/
 void TFT_GFX::fillEllipse(int16_t x0, int16_t y0, int32_t rx, int32_t ry, rgb_t color)
 {
+  BUS_STATS_API(BUS_API_CIRCLE);
   if (rx<2) return;
   if (ry<2) return;
   int32_t x, y;
@@ -1113,12 +1092,15 @@ void TFT_GFX::fillEllipse(int16_t x0, int16_t y0, int32_t rx, int32_t ry, rgb_t
   int32_t fy2 = 4 * ry2;
   int32_t s;
 
+  span_t   span[SPAN_BATCH];
+  uint16_t n = 0;
+
   //begin_tft_write();          // Sprite class can use this function, avoiding begin_tft_write()
   inTransaction = true;
 
   for (x = 0, y = ry, s = 2*ry2+rx2*(1-2*ry); ry2*x <= rx2*y; x++) {
-    drawFastHLine(x0 - x, y0 - y, x + x + 1, color);
-    drawFastHLine(x0 - x, y0 + y, x + x + 1, color);
+    addSpan(span, &n, x0 - x, y0 - y, x + x + 1, color);
+    addSpan(span, &n, x0 - x, y0 + y, x + x + 1, color);
 
     if (s >= 0) {
       s += fx2 * (1 - y);
@@ -1128,8 +1110,8 @@ void TFT_GFX::fillEllipse(int16_t x0, int16_t y0, int32_t rx, int32_t ry, rgb_t
   }
 
   for (x = rx, y = 0, s = 2*rx2+ry2*(1-2*rx); rx2*y <= ry2*x; y++) {
-    drawFastHLine(x0 - x, y0 - y, x + x + 1, color);
-    drawFastHLine(x0 - x, y0 + y, x + x + 1, color);
+    addSpan(span, &n, x0 - x, y0 - y, x + x + 1, color);
+    addSpan(span, &n, x0 - x, y0 + y, x + x + 1, color);
 
     if (s >= 0) {
       s += fy2 * (1 - x);
@@ -1138,6 +1120,8 @@ void TFT_GFX::fillEllipse(int16_t x0, int16_t y0, int32_t rx, int32_t ry, rgb_t
     s += rx2 * ((4 * y) + 6);
   }
 
+  if (n) fillSpans(span, n, color);
+
   inTransaction = lockTransaction;
   end_tft_write();              // Does nothing if Sprite class uses this function
 }
@@ -1150,6 +1134,7 @@ void TFT_GFX::fillEllipse(int16_t x0, int16_t y0, int32_t rx, int32_t ry, rgb_t
 // Draw a rectangle
 void TFT_GFX::drawRect(int32_t x, int32_t y, int32_t w, int32_t h, rgb_t color)
 {
+  BUS_STATS_API(BUS_API_RECT);
   //begin_tft_write();          // Sprite class can use this function, avoiding begin_tft_write()
   inTransaction = true;
 
@@ -1171,6 +1156,7 @@ void TFT_GFX::drawRect(int32_t x, int32_t y, int32_t w, int32_t h, rgb_t color)
 // Draw a rounded rectangle
 void TFT_GFX::drawRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, rgb_t color)
 {
+  BUS_STATS_API(BUS_API_RECT);
   //begin_tft_write();          // Sprite class can use this function, avoiding begin_tft_write()
   inTransaction = true;
 
@@ -1197,6 +1183,7 @@ void TFT_GFX::drawRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t
 // Fill a rounded rectangle, changed to horizontal lines (faster in sprites)
 void TFT_GFX::fillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, rgb_t color)
 {
+  BUS_STATS_API(BUS_API_RECT);
   //begin_tft_write();          // Sprite class can use this function, avoiding begin_tft_write()
   inTransaction = true;
 
@@ -1219,6 +1206,7 @@ void TFT_GFX::fillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t
 // Draw a triangle
 void TFT_GFX::drawTriangle(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, rgb_t color)
 {
+  BUS_STATS_API(BUS_API_TRIANGLE);
   //begin_tft_write();          // Sprite class can use this function, avoiding begin_tft_write()
   inTransaction = true;
 
@@ -1238,6 +1226,7 @@ void TFT_GFX::drawTriangle(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32
 // Fill a triangle - original Adafruit function works well and code footprint is small
 void TFT_GFX::fillTriangle ( int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, rgb_t color)
 {
+  BUS_STATS_API(BUS_API_TRIANGLE);
   int32_t a, b, y, last;
 
   // Sort coordinates by Y order (y2 >= y1 >= y0)
@@ -1274,6 +1263,9 @@ void TFT_GFX::fillTriangle ( int32_t x0, int32_t y0, int32_t x1, int32_t y1, int
   sa   = 0,
   sb   = 0;
 
+  span_t   span[SPAN_BATCH];
+  uint16_t n = 0;
+
   // For upper part of triangle, find scanline crossings for segments
   // 0-1 and 0-2.  If y1=y2 (flat-bottomed triangle), the scanline y1
   // is included here (and second loop will be skipped, avoiding a /0
@@ -1290,7 +1282,7 @@ void TFT_GFX::fillTriangle ( int32_t x0, int32_t y0, int32_t x1, int32_t y1, int
     sb += dx02;
 
     if (a > b) transpose(a, b);
-    drawFastHLine(a, y, b - a + 1, color);
+    addSpan(span, &n, a, y, b - a + 1, color);
   }
 
   // For lower part of triangle, find scanline crossings for segments
@@ -1304,11 +1296,146 @@ void TFT_GFX::fillTriangle ( int32_t x0, int32_t y0, int32_t x1, int32_t y1, int
     sb += dx02;
 
     if (a > b) transpose(a, b);
-    drawFastHLine(a, y, b - a + 1, color);
+    addSpan(span, &n, a, y, b - a + 1, color);
+  }
+
+  if (n) fillSpans(span, n, color);
+
+  inTransaction = lockTransaction;
+  end_tft_write();              // Does nothing if Sprite class uses this function
+}
+
+
+/***************************************************************************************
+** Function name:           fillPolygon
+** Description:             Fill a polygon with an edge table and merged spans
+***************************************************************************************/
+// Pixel x, y is filled if x, y is inside the outline, so a polygon with the corners
+// of a w x h rectangle fills the same pixels as fillRect()
+bool TFT_GFX::fillPolygon(const poly_point_t *points, uint16_t n, rgb_t color, bool nonZero)
+{
+  BUS_STATS_API(BUS_API_POLYGON);
+  if (_vpOoB || n < 3) return true;
+
+  typedef struct {
+    int32_t y0, y1;  // Rows covered, y0 to y1 - 1
+    int64_t x0, dx;  // x at y0 and its step per row, 16.16 fixed point, a step of
+                     // up to 65535 pixels does not fit in 32 bits
+    int8_t  dir;     // Winding direction, +1 down, -1 up
+  } poly_edge_t;
+
+  typedef struct {
+    int64_t x, dx;
+    int32_t y1;
+    int8_t  dir;
+  } poly_active_t;
+
+  // Edge and active edge tables, on the stack unless the polygon is large
+  poly_edge_t   edgeMem[POLY_EDGES];
+  poly_active_t actMem[POLY_EDGES];
+  poly_edge_t   *edge = edgeMem;
+  poly_active_t *act  = actMem;
+  void *heap = nullptr;
+  if (n > POLY_EDGES) {
+    heap = malloc(n * (sizeof(poly_edge_t) + sizeof(poly_active_t)));
+    if (!heap) return false;
+    edge = (poly_edge_t *)heap;
+    act  = (poly_active_t *)(edge + n);
+  }
+
+  // Edge table, horizontal edges are dropped, sorted by first row
+  uint16_t ne = 0;
+  int32_t ymin = INT32_MAX, ymax = INT32_MIN;
+
+  for (uint16_t i = 0; i < n; i++) {
+    const poly_point_t *a = &points[i];
+    const poly_point_t *b = &points[(i + 1) == n ? 0 : i + 1];
+    if (a->y == b->y) continue;
+
+    poly_edge_t e;
+    e.dir = 1;
+    if (a->y > b->y) { const poly_point_t *t = a; a = b; b = t; e.dir = -1; }
+    e.y0 = a->y;
+    e.y1 = b->y;
+    e.dx = ((int64_t)(b->x - a->x) << 16) / (e.y1 - e.y0);
+    e.x0 = (int64_t)a->x << 16;
+
+    if (e.y0 < ymin) ymin = e.y0;
+    if (e.y1 > ymax) ymax = e.y1;
+
+    int32_t k = ne++;
+    while (k > 0 && edge[k - 1].y0 > e.y0) { edge[k] = edge[k - 1]; k--; }
+    edge[k] = e;
+  }
+  if (!ne) { free(heap); return true; }
+
+  // Only the rows in the viewport are scanned
+  int32_t ys = _vpY - _yDatum;
+  int32_t ye = _vpH - _yDatum;
+  if (ymin < ys) ymin = ys;
+  if (ymax > ye) ymax = ye;
+
+  uint16_t na = 0, next = 0;
+
+  span_t   span[SPAN_BATCH];
+  uint16_t ns = 0;
+
+  //begin_tft_write();          // Sprite class can use this function, avoiding begin_tft_write()
+  inTransaction = true;
+
+  for (int32_t y = ymin; y < ymax; y++) {
+    // Drop the edges that ended
+    uint16_t k = 0;
+    for (uint16_t i = 0; i < na; i++) if (act[i].y1 > y) act[k++] = act[i];
+    na = k;
+
+    // Add the edges that start, x is found at this row as the first rows may be clipped
+    while (next < ne && edge[next].y0 <= y) {
+      const poly_edge_t *e = &edge[next++];
+      if (e->y1 <= y) continue;
+      act[na].x   = e->x0 + e->dx * (y - e->y0);
+      act[na].dx  = e->dx;
+      act[na].y1  = e->y1;
+      act[na].dir = e->dir;
+      na++;
+    }
+
+    // Keep the active edges in x order, they are nearly sorted from the row before
+    for (uint16_t i = 1; i < na; i++) {
+      poly_active_t t = act[i];
+      int32_t j = i;
+      while (j > 0 && act[j - 1].x > t.x) { act[j] = act[j - 1]; j--; }
+      act[j] = t;
+    }
+
+    // Spans of the pixels from sx to ex - 1 inside, touching spans are merged
+    int32_t sx = 0, ex = 0, wind = 0;
+    bool open = false;
+    for (uint16_t i = 0; i < na; i++) {
+      bool wasIn = nonZero ? (wind != 0) : (wind & 1);
+      wind += act[i].dir;
+      bool inside = nonZero ? (wind != 0) : (wind & 1);
+      int32_t px = (int32_t)((act[i].x + 0xFFFF) >> 16); // First pixel at or right of the edge
+      if (inside && !wasIn) {
+        if (open && px <= ex) continue; // Joins the span before
+        if (open) addSpan(span, &ns, sx, y, ex - sx, color);
+        sx = px;
+        open = true;
+      }
+      else if (!inside && wasIn) ex = px;
+    }
+    if (open) addSpan(span, &ns, sx, y, ex - sx, color);
+
+    for (uint16_t i = 0; i < na; i++) act[i].x += act[i].dx;
   }
 
+  if (ns) fillSpans(span, ns, color);
+
   inTransaction = lockTransaction;
   end_tft_write();              // Does nothing if Sprite class uses this function
+
+  free(heap);
+  return true;
 }
 
 
@@ -1318,6 +1445,7 @@ void TFT_GFX::fillTriangle ( int32_t x0, int32_t y0, int32_t x1, int32_t y1, int
 ***************************************************************************************/
 void TFT_GFX::drawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, rgb_t color)
 {
+  BUS_STATS_API(BUS_API_BITMAP);
   //begin_tft_write();          // Sprite class can use this function, avoiding begin_tft_write()
   inTransaction = true;
 
@@ -1342,6 +1470,7 @@ void TFT_GFX::drawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w,
 ***************************************************************************************/
 void TFT_GFX::drawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, rgb_t fgcolor, rgb_t bgcolor)
 {
+  BUS_STATS_API(BUS_API_BITMAP);
   //begin_tft_write();          // Sprite class can use this function, avoiding begin_tft_write()
   inTransaction = true;
 
@@ -1365,6 +1494,7 @@ void TFT_GFX::drawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w,
 ***************************************************************************************/
 void TFT_GFX::drawXBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, rgb_t color)
 {
+  BUS_STATS_API(BUS_API_BITMAP);
   //begin_tft_write();          // Sprite class can use this function, avoiding begin_tft_write()
   inTransaction = true;
 
@@ -1389,6 +1519,7 @@ void TFT_GFX::drawXBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w
 ***************************************************************************************/
 void TFT_GFX::drawXBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, rgb_t color, rgb_t bgcolor)
 {
+  BUS_STATS_API(BUS_API_BITMAP);
   //begin_tft_write();          // Sprite class can use this function, avoiding begin_tft_write()
   inTransaction = true;
 
@@ -1427,11 +1558,9 @@ void TFT_GFX::setBitmapColor(rgb_t c, rgb_t b)
 // an efficient FastH/V Line draw routine for line segments of 2 pixels or more
 void TFT_GFX::drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, rgb_t color)
 {
+  BUS_STATS_API(BUS_API_DRAWLINE);
   if (_vpOoB) return;
 
-  //begin_tft_write();       // Sprite class can use this function, avoiding begin_tft_write()
-  inTransaction = true;
-
   //x+= _xDatum;             // Not added here, added by drawPixel & drawFastXLine
   //y+= _yDatum;
 
@@ -1452,6 +1581,13 @@ void TFT_GFX::drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, rgb_t col
 
   if (y0 < y1) ystep = 1;
 
+  // Only the pixels in the viewport are stepped through
+  if (!clipBresenham(&x0, &y0, &x1, &err, dx, dy, ystep, steep)) return;
+  xs = x0;
+
+  //begin_tft_write();       // Sprite class can use this function, avoiding begin_tft_write()
+  inTransaction = true;
+
   // Split into steep and not steep for FastH/V separation
   if (steep) {
     for (; x0 <= x1; x0++) {
@@ -1488,14 +1624,135 @@ void TFT_GFX::drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, rgb_t col
 }
 
 
+/***************************************************************************************
+** Function name:           clipBresenham
+** Description:             clip a drawLine() to the viewport before it is stepped
+***************************************************************************************/
+// Pixel k of the line is at u0 + k, v0 + vstep * m(k), where m(k) minor steps have been
+// taken. The error term stays in 0 to dx - 1, so after k pixels it is e0 - k*dy + m*dx
+// with m(k) = ceil((k*dy - e0) / dx), e0 = dx/2. This is inverted to find the k range
+// inside the viewport, the pixels drawn are exactly those of the unclipped line.
+bool TFT_GFX::clipBresenham(int32_t *u0, int32_t *v0, int32_t *u1, int32_t *err,
+                            int32_t dx, int32_t dy, int32_t vstep, bool steep)
+{
+  // Viewport in the coordinates of the line
+  int32_t umin = _vpX - _xDatum, umax = _vpW - 1 - _xDatum;
+  int32_t vmin = _vpY - _yDatum, vmax = _vpH - 1 - _yDatum;
+  if (steep) {
+    transpose(umin, vmin);
+    transpose(umax, vmax);
+  }
+
+  // Range of k along the major axis
+  int64_t klo = (int64_t)umin - *u0, khi = (int64_t)umax - *u0;
+  if (klo < 0)  klo = 0;
+  if (khi > dx) khi = dx;
+
+  // Range of minor steps m
+  int64_t mlo, mhi;
+  if (vstep > 0) { mlo = (int64_t)vmin - *v0; mhi = (int64_t)vmax - *v0; }
+  else           { mlo = (int64_t)*v0 - vmax; mhi = (int64_t)*v0 - vmin; }
+  if (mhi < 0) return false;
+
+  int64_t e0 = dx >> 1;
+  if (dy == 0) {
+    if (mlo > 0) return false;
+  }
+  else {
+    // m(k) >= mlo from the first k with k*dy > (mlo - 1)*dx + e0
+    if (mlo > 0) {
+      int64_t k = ((mlo - 1) * dx + e0) / dy + 1;
+      if (k > klo) klo = k;
+    }
+    // m(k) <= mhi up to the last k with k*dy <= mhi*dx + e0
+    int64_t k = (mhi * dx + e0) / dy;
+    if (k < khi) khi = k;
+  }
+  if (klo > khi) return false;
+
+  int64_t m = 0;
+  if (klo * dy > e0) m = (klo * dy - e0 + dx - 1) / dx;
+
+  *err = e0 - klo * dy + m * dx;
+  *u1  = *u0 + khi;
+  *u0 += klo;
+  *v0 += vstep * m;
+  return true;
+}
+
+
 /***************************************************************************************
 ** Description:  Constants for anti-aliased line drawing on TFT and in Sprites
 ***************************************************************************************/
 constexpr float PixelAlphaGain   = 255.0;
 constexpr float LoAlphaTheshold  = 1.0/32.0;
 constexpr float HiAlphaTheshold  = 1.0 - LoAlphaTheshold;
+
+// Pixels of a drawWedgeLine run blended and plotted together
+#ifndef WEDGE_SPAN
+  #define WEDGE_SPAN 32
+#endif
 constexpr float deg2rad      = 3.14159265359/180.0;
 
+// sin() of 0 to 90 degrees in Q16.16, 90 is 65535 to fit
+static const uint16_t sinDegLut[91] = {
+      0,  1144,  2287,  3430,  4572,  5712,  6850,  7987,  9121, 10252,
+  11380, 12505, 13626, 14742, 15855, 16962, 18064, 19161, 20252, 21336,
+  22415, 23486, 24550, 25607, 26656, 27697, 28729, 29753, 30767, 31772,
+  32768, 33754, 34729, 35693, 36647, 37590, 38521, 39441, 40348, 41243,
+  42126, 42995, 43852, 44695, 45525, 46341, 47143, 47930, 48703, 49461,
+  50203, 50931, 51643, 52339, 53020, 53684, 54332, 54963, 55578, 56175,
+  56756, 57319, 57865, 58393, 58903, 59396, 59870, 60326, 60764, 61183,
+  61584, 61966, 62328, 62672, 62997, 63303, 63589, 63856, 64104, 64332,
+  64540, 64729, 64898, 65048, 65177, 65287, 65376, 65446, 65496, 65526,
+  65535
+};
+
+/***************************************************************************************
+** Function name:           sinDegFx, cosDegFx - file static smooth graphics helpers
+** Description:             sin() and cos() of whole degrees in Q16.16
+***************************************************************************************/
+static int32_t sinDegFx(int32_t a)
+{
+  a %= 360;
+  if (a < 0) a += 360;
+  if (a <=  90) return  sinDegLut[a];
+  if (a <= 180) return  sinDegLut[180 - a];
+  if (a <= 270) return -sinDegLut[a - 180];
+  return -sinDegLut[360 - a];
+}
+
+static inline int32_t cosDegFx(int32_t a) { return sinDegFx(a + 90); }
+
+#ifdef SMOOTH_FIXED
+// The thresholds in Q16.16
+constexpr int32_t LoAlphaFx = 65536 / 32;
+constexpr int32_t HiAlphaFx = 65536 - LoAlphaFx;
+
+/***************************************************************************************
+** Function name:           isqrt64 - file static smooth graphics helper
+** Description:             integer square root, rounded down
+***************************************************************************************/
+// A Q32.32 number gives a Q16.16 root
+static uint32_t isqrt64(uint64_t num)
+{
+  uint64_t res = 0;
+  uint64_t bit = (uint64_t)1 << 62;
+
+  while (bit > num) bit >>= 2;
+
+  while (bit) {
+    if (num >= res + bit) {
+      num -= res + bit;
+      res = (res >> 1) + bit;
+    }
+    else res >>= 1;
+    bit >>= 2;
+  }
+  return (uint32_t)res;
+}
+#endif
+
 /***************************************************************************************
 ** Function name:           drawPixel (alpha blended)
 ** Description:             Draw a pixel blended with the screen or bg pixel colour
@@ -1503,6 +1760,7 @@ constexpr float deg2rad      = 3.14159265359/180.0;
 ***************************************************************************************/
 rgb_t TFT_GFX::drawAlphaPixel(int32_t x, int32_t y, rgb_t color, uint8_t alpha, rgb_t bg_color)
 {
+  BUS_STATS_API(BUS_API_ALPHAPIXEL);
   if (bg_color == WHITE) bg_color = readPixel(x, y);
   color = alphaBlend(alpha, color, bg_color);
   drawPixel(x, y, color);
@@ -1522,10 +1780,40 @@ void TFT_GFX::drawSmoothArc(int32_t x, int32_t y, int32_t r, int32_t ir, int32_t
 // anti-aliased roundEnd is optional, default is anti-aliased straight end
 // Note: rounded ends extend the arc angle so can overlap, user sketch to manage this.
 {
+  BUS_STATS_API(BUS_API_SMOOTHARC);
   inTransaction = true;
 
   if (endAngle != startAngle && (startAngle != 0 || endAngle != 360))
   {
+#ifdef SMOOTH_FIXED
+    // Arc end directions in Q16.16
+    int32_t sx = -sinDegFx(startAngle);
+    int32_t sy = +cosDegFx(startAngle);
+    int32_t ex = -sinDegFx(  endAngle);
+    int32_t ey = +cosDegFx(  endAngle);
+    x <<= 16;
+    y <<= 16;
+
+    if (roundEnds)
+    { // Round ends
+      int32_t sr = (r - ir) << 15;
+      sx = sx * (r + ir) / 2 + x;
+      sy = sy * (r + ir) / 2 + y;
+      drawWedgeLineFx(sx, sy, sx, sy, sr, sr, fg_color, bg_color);
+
+      ex = ex * (r + ir) / 2 + x;
+      ey = ey * (r + ir) / 2 + y;
+      drawWedgeLineFx(ex, ey, ex, ey, sr, sr, fg_color, bg_color);
+    }
+    else
+    { // Square ends, 0.3 pixel radius
+      drawWedgeLineFx(sx * ir + x, sy * ir + y, sx * r + x, sy * r + y, 19661, 19661, fg_color, bg_color);
+      drawWedgeLineFx(ex * ir + x, ey * ir + y, ex * r + x, ey * r + y, 19661, 19661, fg_color, bg_color);
+    }
+
+    x >>= 16;
+    y >>= 16;
+#else
     float sx = -sinf(startAngle * deg2rad);
     float sy = +cosf(startAngle * deg2rad);
     float ex = -sinf(  endAngle * deg2rad);
@@ -1555,6 +1843,7 @@ void TFT_GFX::drawSmoothArc(int32_t x, int32_t y, int32_t r, int32_t ir, int32_t
       aey = ey *  r + y;
       drawWedgeLine(asx, asy, aex, aey, 0.3, 0.3, fg_color, bg_color);
     }
+#endif
 
     // Draw arc
     drawArc(x, y, r, ir, startAngle, endAngle, fg_color, bg_color);
@@ -1613,6 +1902,7 @@ void TFT_GFX::drawArc(int32_t x, int32_t y, int32_t r, int32_t ir,
                        rgb_t fg_color, rgb_t bg_color,
                        bool smooth)
 {
+  BUS_STATS_API(BUS_API_SMOOTHARC);
   if (endAngle   > 360)   endAngle = 360;
   if (startAngle > 360) startAngle = 360;
   if (_vpOoB || startAngle == endAngle) return;
@@ -1646,6 +1936,16 @@ void TFT_GFX::drawArc(int32_t x, int32_t y, int32_t r, int32_t ir,
   uint32_t   endSlope[4] = {0, 0xFFFFFFFF, 0, 0};
 
   // Ensure maximum U16.16 slope of arc ends is ~ 0x8000 0000
+#ifdef SMOOTH_FIXED
+  constexpr uint32_t minDivisor = 2; // 1/0x8000 in U16.16
+
+  // Fill in start slope table and empty quadrants
+  uint32_t fabscos = abs(cosDegFx(startAngle));
+  uint32_t fabssin = abs(sinDegFx(startAngle));
+
+  // U16.16 slope of arc start
+  uint32_t slope = ((uint64_t)fabscos << 16) / (fabssin + minDivisor);
+#else
   constexpr float minDivisor = 1.0f/0x8000;
 
   // Fill in start slope table and empty quadrants
@@ -1654,6 +1954,7 @@ void TFT_GFX::drawArc(int32_t x, int32_t y, int32_t r, int32_t ir,
 
   // U16.16 slope of arc start
   uint32_t slope = (fabscos/(fabssin + minDivisor)) * (float)(1UL<<16);
+#endif
 
   // Update slope table, add slope for arc start
   if (startAngle <= 90) {
@@ -1673,11 +1974,19 @@ void TFT_GFX::drawArc(int32_t x, int32_t y, int32_t r, int32_t ir,
   }
 
   // Fill in end slope table and empty quadrants
+#ifdef SMOOTH_FIXED
+  fabscos  = abs(cosDegFx(endAngle));
+  fabssin  = abs(sinDegFx(endAngle));
+
+  // U16.16 slope of arc end
+  slope   = ((uint64_t)fabscos << 16) / (fabssin + minDivisor);
+#else
   fabscos  = fabsf(cosf(endAngle * deg2rad));
   fabssin  = fabsf(sinf(endAngle * deg2rad));
 
   // U16.16 slope of arc end
   slope   = (uint32_t)((fabscos/(fabssin + minDivisor)) * (float)(1UL<<16));
+#endif
 
   // Work out which quadrants will need to be drawn and add slope for arc end
   if (endAngle <= 90) {
@@ -1781,6 +2090,7 @@ void TFT_GFX::drawArc(int32_t x, int32_t y, int32_t r, int32_t ir,
 // To have effective anti-aliasing the circle will be 3 pixels thick
 void TFT_GFX::drawSmoothCircle(int32_t x, int32_t y, int32_t r, rgb_t fg_color, rgb_t bg_color)
 {
+  BUS_STATS_API(BUS_API_SMOOTHSHAPE);
   drawSmoothRoundRect(x-r, y-r, r, r-1, 0, 0, fg_color, bg_color);
 }
 
@@ -1790,6 +2100,7 @@ void TFT_GFX::drawSmoothCircle(int32_t x, int32_t y, int32_t r, rgb_t fg_color,
 ***************************************************************************************/
 void TFT_GFX::fillSmoothCircle(int32_t x, int32_t y, int32_t r, rgb_t color, rgb_t bg_color)
 {
+  BUS_STATS_API(BUS_API_SMOOTHSHAPE);
   if (r <= 0) return;
 
   inTransaction = true;
@@ -1853,6 +2164,7 @@ void TFT_GFX::fillSmoothCircle(int32_t x, int32_t y, int32_t r, rgb_t color, rgb
 //   0x8 | 0x4
 void TFT_GFX::drawSmoothRoundRect(int32_t x, int32_t y, int32_t r, int32_t ir, int32_t w, int32_t h, rgb_t fg_color, rgb_t bg_color, uint8_t quadrants)
 {
+  BUS_STATS_API(BUS_API_SMOOTHSHAPE);
   if (_vpOoB) return;
   if (r < ir) transpose(r, ir); // Required that r > ir
   if (r <= 0 || ir < 0) return; // Invalid
@@ -1946,6 +2258,7 @@ void TFT_GFX::drawSmoothRoundRect(int32_t x, int32_t y, int32_t r, int32_t ir, i
 ***************************************************************************************/
 void TFT_GFX::fillSmoothRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, rgb_t color, rgb_t bg_color)
 {
+  BUS_STATS_API(BUS_API_SMOOTHSHAPE);
   inTransaction = true;
 
   int32_t xs = 0;
@@ -2001,6 +2314,7 @@ void TFT_GFX::fillSmoothRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, in
 // Coordinates are floating point to achieve sub-pixel positioning
 void TFT_GFX::drawSpot(float ax, float ay, float r, uint32_t fg_color, uint32_t bg_color)
 {
+  BUS_STATS_API(BUS_API_WEDGELINE);
   // Filled circle can be created by the wide line function with zero line length
   drawWedgeLine( ax, ay, ax, ay, r, r, fg_color, bg_color);
 }
@@ -2011,16 +2325,169 @@ void TFT_GFX::drawSpot(float ax, float ay, float r, uint32_t fg_color, uint32_t
 ***************************************************************************************/
 void TFT_GFX::drawWideLine(float ax, float ay, float bx, float by, float wd, rgb_t fg_color, rgb_t bg_color)
 {
+  BUS_STATS_API(BUS_API_WEDGELINE);
   drawWedgeLine( ax, ay, bx, by, wd/2.0, wd/2.0, fg_color, bg_color);
 }
 
+#ifndef SMOOTH_FIXED
+/***************************************************************************************
+** Function name:           wedgeSpanCut - file static helper for wedgeLineSpan
+** Description:             narrow lo..hi to the u that meet a * u + b <= 0
+***************************************************************************************/
+static inline void wedgeSpanCut(float a, float b, float *lo, float *hi)
+{
+  if (a > 0.0f) *hi = fminf(*hi, -b / a);
+  else if (a < 0.0f) *lo = fmaxf(*lo, -b / a);
+  else if (b > 0.0f) *hi = -INFINITY;
+}
+
+/***************************************************************************************
+** Function name:           wedgeLineSpan - file static helper for drawWedgeLine
+** Description:             u ranges of a row of the wedge where wedgeLineDistance <= t
+***************************************************************************************/
+// The distance is |P| before the start (h <= 0), |P - BA| + dr after the end (h >= 1)
+// and |c| + dr * h in between, with h and the signed distance c from the line both linear
+// in u along the row. Each part is an interval, up to three are returned in order of u,
+// they may overlap and there may be gaps between them where the ends differ in size.
+static int32_t wedgeLineSpan(float ypay, float bax, float bay, float len2, float len, float dr,
+                             float t, float *lo, float *hi)
+{
+  float hu = bax / len2, h0 = ypay * bay / len2; // h  = hu * u + h0
+  float cu = bay / len,  c0 = -ypay * bax / len; // c  = cu * u + c0
+  float l[3], r[3];
+
+  // Round start
+  l[0] = INFINITY; r[0] = -INFINITY;
+  float q = t * t - ypay * ypay;
+  if (t >= 0.0f && q >= 0.0f) {
+    l[0] = -sqrtf(q); r[0] = -l[0];
+    wedgeSpanCut(hu, h0, &l[0], &r[0]);
+  }
+
+  // Tapered middle
+  l[1] = -INFINITY; r[1] = INFINITY;
+  wedgeSpanCut(-hu, -h0, &l[1], &r[1]);
+  wedgeSpanCut( hu, h0 - 1.0f, &l[1], &r[1]);
+  wedgeSpanCut( cu + dr * hu,  c0 + dr * h0 - t, &l[1], &r[1]);
+  wedgeSpanCut(-cu + dr * hu, -c0 + dr * h0 - t, &l[1], &r[1]);
+
+  // Round end, its radius is smaller by dr
+  l[2] = INFINITY; r[2] = -INFINITY;
+  float te = t - dr, yb = ypay - bay;
+  q = te * te - yb * yb;
+  if (te >= 0.0f && q >= 0.0f) {
+    l[2] = bax - sqrtf(q); r[2] = bax + sqrtf(q);
+    wedgeSpanCut(-hu, 1.0f - h0, &l[2], &r[2]);
+  }
+
+  // h falls along the row if the line points left
+  int32_t n = 0;
+  for (int32_t i = 0; i < 3; i++) {
+    int32_t j = (hu < 0.0f) ? 2 - i : i;
+    if (l[j] <= r[j]) { lo[n] = l[j]; hi[n] = r[j]; n++; }
+  }
+  return n;
+}
+
+#else
+/***************************************************************************************
+** Function name:           wedgeSpanCutFx - file static helper for wedgeLineSpanFx
+** Description:             narrow lo..hi to the u that meet u * a <= n
+***************************************************************************************/
+static inline void wedgeSpanCutFx(int32_t a, int64_t n, int32_t *lo, int32_t *hi)
+{
+  if (a > 0) {
+    int64_t u = n / a;
+    if (u < *hi) *hi = (int32_t)u;
+  }
+  else if (a < 0) {
+    int64_t u = n / a;
+    if (u > *lo) *lo = (int32_t)u;
+  }
+  else if (n < 0) { *lo = INT32_MAX; *hi = INT32_MIN; }
+}
+
+/***************************************************************************************
+** Function name:           wedgeLineSpanFx - file static helper for drawWedgeLineFx
+** Description:             u ranges of a row of the wedge where the distance <= t
+***************************************************************************************/
+// As wedgeLineSpan, in 1/256 pixels. The tapered middle is scaled by the line length
+// len, dbx and dby are dr * bax / len and dr * bay / len.
+static int32_t wedgeLineSpanFx(int32_t ypay, int32_t bax, int32_t bay, int64_t len2, int32_t len,
+                               int32_t dbx, int32_t dby, int32_t dr, int32_t t, int32_t *lo, int32_t *hi)
+{
+  int32_t l[3], r[3];
+  int64_t yb = (int64_t)ypay * bay; // h * len2 at u = 0
+
+  // Round start
+  l[0] = INT32_MAX; r[0] = INT32_MIN;
+  int64_t q = (int64_t)t * t - (int64_t)ypay * ypay;
+  if (t >= 0 && q >= 0) {
+    r[0] = isqrt64(q); l[0] = -r[0];
+    wedgeSpanCutFx(bax, -yb, &l[0], &r[0]);
+  }
+
+  // Tapered middle
+  l[1] = INT32_MIN; r[1] = INT32_MAX;
+  wedgeSpanCutFx(-bax, yb, &l[1], &r[1]);
+  wedgeSpanCutFx( bax, len2 - yb, &l[1], &r[1]);
+  wedgeSpanCutFx(bay + dbx, (int64_t)t * len + (int64_t)ypay * (bax - dby), &l[1], &r[1]);
+  wedgeSpanCutFx(dbx - bay, (int64_t)t * len - (int64_t)ypay * (bax + dby), &l[1], &r[1]);
+
+  // Round end, its radius is smaller by dr
+  l[2] = INT32_MAX; r[2] = INT32_MIN;
+  int32_t te = t - dr, ye = ypay - bay;
+  q = (int64_t)te * te - (int64_t)ye * ye;
+  if (te >= 0 && q >= 0) {
+    int32_t s = isqrt64(q);
+    l[2] = bax - s; r[2] = bax + s;
+    wedgeSpanCutFx(-bax, yb - len2, &l[2], &r[2]);
+  }
+
+  // h falls along the row if the line points left
+  int32_t n = 0;
+  for (int32_t i = 0; i < 3; i++) {
+    int32_t j = (bax < 0) ? 2 - i : i;
+    if (l[j] <= r[j]) { lo[n] = l[j]; hi[n] = r[j]; n++; }
+  }
+  return n;
+}
+
+/***************************************************************************************
+** Function name:           wedgeLineDistanceFx - file static helper for drawWedgeLineFx
+** Description:             as wedgeLineDistance in Q16.16
+***************************************************************************************/
+// len2 is bax * bax + bay * bay in Q32.32 and len its root. Beside the line the distance
+// is the cross product over the length, so no root is needed and h is not rounded into it.
+static int32_t wedgeLineDistanceFx(int32_t xpax, int32_t ypay, int32_t bax, int32_t bay, int64_t len2, int32_t len, int32_t dr)
+{
+  int64_t dot = (int64_t)xpax * bax + (int64_t)ypay * bay;
+  if (dot <= 0) return isqrt64((int64_t)xpax * xpax + (int64_t)ypay * ypay);
+  if (dot >= len2) {
+    int32_t dx = xpax - bax, dy = ypay - bay;
+    return isqrt64((int64_t)dx * dx + (int64_t)dy * dy) + dr;
+  }
+  int64_t cross = (int64_t)xpax * bay - (int64_t)ypay * bax;
+  if (cross < 0) cross = -cross;
+  if (dr == 0) return (int32_t)(cross / len);
+  int32_t h;
+  if (len2 < ((int64_t)1 << 47)) h = (int32_t)((dot << 16) / len2);
+  else h = (int32_t)(dot / (len2 >> 16));
+  return (int32_t)(cross / len) + (int32_t)(((int64_t)h * dr) >> 16);
+}
+#endif
+
 /***************************************************************************************
 ** Function name:           drawWedgeLine - background colour specified or pixel read
 ** Description:             draw an anti-aliased line with different width radiused ends
 ***************************************************************************************/
 void TFT_GFX::drawWedgeLine(float ax, float ay, float bx, float by, float ar, float br, rgb_t fg_color, rgb_t bg_color)
 {
+  BUS_STATS_API(BUS_API_WEDGELINE);
   if ( (ar < 0.0) || (br < 0.0) )return;
+#ifdef SMOOTH_FIXED
+  drawWedgeLineFx(ax * 65536.0f, ay * 65536.0f, bx * 65536.0f, by * 65536.0f, ar * 65536.0f, br * 65536.0f, fg_color, bg_color);
+#else
   if ( (fabsf(ax - bx) < 0.01f) && (fabsf(ay - by) < 0.01f) ) bx += 0.01f;  // Avoid divide by zero
 
   // Find line bounding box
@@ -2031,98 +2498,192 @@ void TFT_GFX::drawWedgeLine(float ax, float ay, float bx, float by, float ar, fl
 
   if (!clipWindow(&x0, &y0, &x1, &y1)) return;
 
-  // Establish x start and y start
-  int32_t ys = ay;
-  if ((ax-ar)>(bx-br)) ys = by;
+  // The line in screen coordinates, as the clipped box
+  ax += _xDatum; bx += _xDatum;
+  ay += _yDatum; by += _yDatum;
 
   float rdt = ar - br; // Radius delta
-  float alpha = 1.0f;
   ar += 0.5;
 
-  uint16_t bg = bg_color;
-  float xpax, ypay, bax = bx - ax, bay = by - ay;
+  float bax = bx - ax, bay = by - ay;
+  float len2 = bax * bax + bay * bay, len = sqrtf(len2);
+
+  // Pixels nearer than tIn are solid, those nearer than tOut are blended
+  float tIn  = ar - HiAlphaTheshold;
+  float tOut = ar - LoAlphaTheshold;
+
+  // Run of pixels blended and plotted together
+  rgb_t   spanBg[WEDGE_SPAN];
+  uint8_t spanAlpha[WEDGE_SPAN];
 
   begin_nin_write();
   inTransaction = true;
 
-  int32_t xs = x0;
-  // Scan bounding box from ys down, calculate pixel intensity from distance to line
-  for (int32_t yp = ys; yp <= y1; yp++) {
-    bool swin = true;  // Flag to start new window area
-    bool endX = false; // Flag to skip pixels
-    ypay = yp - ay;
-    for (int32_t xp = xs; xp <= x1; xp++) {
-      if (endX) if (alpha <= LoAlphaTheshold) break;  // Skip right side
-      xpax = xp - ax;
-      alpha = ar - wedgeLineDistance(xpax, ypay, bax, bay, rdt);
-      if (alpha <= LoAlphaTheshold ) continue;
-      // Track edge to minimise calculations
-      if (!endX) { endX = true; xs = xp; }
-      if (alpha > HiAlphaTheshold) {
-        #ifdef GC9A01_DRIVER
-          drawPixel(xp, yp, fg_color);
-        #else
-          if (swin) { setWindow(xp, yp, x1, yp); swin = false; }
-          pushColor(fg_color);
-        #endif
-        continue;
+  for (int32_t yp = y0; yp <= y1; yp++) {
+    float ypay = yp - ay;
+    float lo[3], hi[3];
+
+    // Pixels of the row that may be drawn, rounded out so none is missed
+    int32_t k = wedgeLineSpan(ypay, bax, bay, len2, len, rdt, tOut, lo, hi);
+    if (!k) continue;
+    int32_t xl = (int32_t)floorf(ax + lo[0]), xr = (int32_t)ceilf(ax + hi[k - 1]);
+    if (xl < x0) xl = x0;
+    if (xr > x1) xr = x1;
+    if (xl > xr) continue;
+
+    // Solid runs, their ends are checked as the intervals are rounded in
+    int32_t sl[3], sr[3], runs = 0;
+    k = wedgeLineSpan(ypay, bax, bay, len2, len, rdt, tIn, lo, hi);
+    for (int32_t i = 0; i < k; i++) {
+      int32_t l = (int32_t)ceilf(ax + lo[i]), r = (int32_t)floorf(ax + hi[i]);
+      if (l < xl) l = xl;
+      if (r > xr) r = xr;
+      while (l <= r && ar - wedgeLineDistance(l - ax, ypay, bax, bay, rdt) <= HiAlphaTheshold) l++;
+      while (r >= l && ar - wedgeLineDistance(r - ax, ypay, bax, bay, rdt) <= HiAlphaTheshold) r--;
+      if (l > r) continue;
+      if (runs && l <= sr[runs - 1] + 1) { if (r > sr[runs - 1]) sr[runs - 1] = r; }
+      else { sl[runs] = l; sr[runs] = r; runs++; }
+    }
+
+    // Anti-aliased fringe before each solid run, and after the last
+    int32_t xs = xl;
+    for (int32_t i = 0; i <= runs; i++) {
+      int32_t xe = (i < runs) ? sl[i] - 1 : xr;
+      int32_t n = 0, sx = 0; // Run length and start
+      for (int32_t xp = xs; xp <= xe; xp++) {
+        float alpha = ar - wedgeLineDistance(xp - ax, ypay, bax, bay, rdt);
+        if (alpha <= LoAlphaTheshold) {
+          if (n) { pushSpan(sx, yp, fg_color, spanBg, spanAlpha, n); n = 0; }
+          continue;
+        }
+        if (n == 0) sx = xp;
+        if (alpha > HiAlphaTheshold) spanAlpha[n] = 255;
+        else spanAlpha[n] = (uint8_t)(alpha * PixelAlphaGain);
+        // Read the background of blended pixels if needed
+        if (bg_color == 0x00FFFFFF && spanAlpha[n] != 255) spanBg[n] = readPixel(xp - _xDatum, yp - _yDatum);
+        else spanBg[n] = bg_color;
+        if (++n == WEDGE_SPAN) { pushSpan(sx, yp, fg_color, spanBg, spanAlpha, n); n = 0; }
       }
-      //Blend color with background and plot
-      if (bg_color == 0x00FFFFFF) {
-        bg = readPixel(xp, yp); swin = true;
+      if (n) pushSpan(sx, yp, fg_color, spanBg, spanAlpha, n);
+      if (i < runs) {
+        drawFastHLine(sl[i] - _xDatum, yp - _yDatum, sr[i] - sl[i] + 1, fg_color);
+        xs = sr[i] + 1;
       }
-      #ifdef GC9A01_DRIVER
-        uint16_t pcol = fastBlend((uint8_t)(alpha * PixelAlphaGain), fg_color, bg);
-        drawPixel(xp, yp, pcol);
-        swin = swin;
-      #else
-        if (swin) { setWindow(xp, yp, x1, yp); swin = false; }
-        pushColor(fastBlend((uint8_t)(alpha * PixelAlphaGain), fg_color, bg));
-      #endif
     }
   }
 
-  // Reset x start to left side of box
-  xs = x0;
-  // Scan bounding box from ys-1 up, calculate pixel intensity from distance to line
-  for (int32_t yp = ys-1; yp >= y0; yp--) {
-    bool swin = true;  // Flag to start new window area
-    bool endX = false; // Flag to skip pixels
-    ypay = yp - ay;
-    for (int32_t xp = xs; xp <= x1; xp++) {
-      if (endX) if (alpha <= LoAlphaTheshold) break;  // Skip right side of drawn line
-      xpax = xp - ax;
-      alpha = ar - wedgeLineDistance(xpax, ypay, bax, bay, rdt);
-      if (alpha <= LoAlphaTheshold ) continue;
-      // Track line boundary
-      if (!endX) { endX = true; xs = xp; }
-      if (alpha > HiAlphaTheshold) {
-        #ifdef GC9A01_DRIVER
-          drawPixel(xp, yp, fg_color);
-        #else
-          if (swin) { setWindow(xp, yp, x1, yp); swin = false; }
-          pushColor(fg_color);
-        #endif
-        continue;
+  inTransaction = lockTransaction;
+  end_nin_write();
+#endif
+}
+
+#ifdef SMOOTH_FIXED
+/***************************************************************************************
+** Function name:           drawWedgeLineFx - private function for the smooth graphics
+** Description:             drawWedgeLine in Q16.16 fixed point, no floats
+***************************************************************************************/
+// Coordinates must be within +/-8191 pixels so the products fit 64 bits
+void TFT_GFX::drawWedgeLineFx(int32_t ax, int32_t ay, int32_t bx, int32_t by, int32_t ar, int32_t br, rgb_t fg_color, rgb_t bg_color)
+{
+  if ( (ar < 0) || (br < 0) ) return;
+  if ( (abs(ax - bx) < 655) && (abs(ay - by) < 655) ) bx += 655;  // Avoid divide by zero
+
+  // Find line bounding box
+  int32_t x0 =  ((ax - ar < bx - br) ? ax - ar : bx - br) >> 16;
+  int32_t x1 = (((ax + ar > bx + br) ? ax + ar : bx + br) + 0xFFFF) >> 16;
+  int32_t y0 =  ((ay - ar < by - br) ? ay - ar : by - br) >> 16;
+  int32_t y1 = (((ay + ar > by + br) ? ay + ar : by + br) + 0xFFFF) >> 16;
+
+  if (!clipWindow(&x0, &y0, &x1, &y1)) return;
+
+  // The line in screen coordinates, as the clipped box
+  ax += _xDatum << 16; bx += _xDatum << 16;
+  ay += _yDatum << 16; by += _yDatum << 16;
+
+  int32_t rdt = ar - br; // Radius delta
+  ar += 0x8000;
+
+  int32_t bax = bx - ax, bay = by - ay;
+
+  // Row extents are found in 1/256 pixels
+  int32_t ax8 = ax >> 8, bax8 = bax >> 8, bay8 = bay >> 8, rdt8 = rdt >> 8;
+  int64_t len2 = (int64_t)bax8 * bax8 + (int64_t)bay8 * bay8;
+  int32_t len = isqrt64(len2);
+  int32_t dbx = (int32_t)((int64_t)rdt8 * bax8 / len);
+  int32_t dby = (int32_t)((int64_t)rdt8 * bay8 / len);
+
+  // Length and length squared for the pixel distances, in Q16.16 and Q32.32
+  int64_t lenq = (int64_t)bax * bax + (int64_t)bay * bay;
+  int32_t lenf = isqrt64(lenq);
+
+  // Pixels nearer than tIn are solid, those nearer than tOut are blended
+  int32_t tIn  = (ar - HiAlphaFx) >> 8;
+  int32_t tOut = (ar - LoAlphaFx) >> 8;
+
+  // Run of pixels blended and plotted together
+  rgb_t   spanBg[WEDGE_SPAN];
+  uint8_t spanAlpha[WEDGE_SPAN];
+
+  begin_nin_write();
+  inTransaction = true;
+
+  for (int32_t yp = y0; yp <= y1; yp++) {
+    int32_t ypay = (yp << 16) - ay;
+    int32_t lo[3], hi[3];
+
+    // Pixels of the row that may be drawn, rounded out past the error of the extents
+    int32_t k = wedgeLineSpanFx(ypay >> 8, bax8, bay8, len2, len, dbx, dby, rdt8, tOut, lo, hi);
+    if (!k) continue;
+    int64_t el = (int64_t)ax8 + lo[0] - 4, er = (int64_t)ax8 + hi[k - 1] + 4 + 255;
+    int32_t xl = (el < ((int64_t)x0 << 8)) ? x0 : (int32_t)(el >> 8);
+    int32_t xr = (er > ((int64_t)x1 << 8)) ? x1 : (int32_t)(er >> 8);
+    if (xl > xr) continue;
+
+    // Solid runs, their ends are checked as the intervals are rounded in
+    int32_t sl[3], sr[3], runs = 0;
+    k = wedgeLineSpanFx(ypay >> 8, bax8, bay8, len2, len, dbx, dby, rdt8, tIn, lo, hi);
+    for (int32_t i = 0; i < k; i++) {
+      el = (int64_t)ax8 + lo[i] + 255, er = (int64_t)ax8 + hi[i];
+      int32_t l = (el < ((int64_t)xl << 8)) ? xl : (int32_t)(el >> 8);
+      int32_t r = (er > ((int64_t)xr << 8)) ? xr : (int32_t)(er >> 8);
+      while (l <= r && ar - wedgeLineDistanceFx((l << 16) - ax, ypay, bax, bay, lenq, lenf, rdt) <= HiAlphaFx) l++;
+      while (r >= l && ar - wedgeLineDistanceFx((r << 16) - ax, ypay, bax, bay, lenq, lenf, rdt) <= HiAlphaFx) r--;
+      if (l > r) continue;
+      if (runs && l <= sr[runs - 1] + 1) { if (r > sr[runs - 1]) sr[runs - 1] = r; }
+      else { sl[runs] = l; sr[runs] = r; runs++; }
+    }
+
+    // Anti-aliased fringe before each solid run, and after the last
+    int32_t xs = xl;
+    for (int32_t i = 0; i <= runs; i++) {
+      int32_t xe = (i < runs) ? sl[i] - 1 : xr;
+      int32_t n = 0, sx = 0; // Run length and start
+      for (int32_t xp = xs; xp <= xe; xp++) {
+        int32_t alpha = ar - wedgeLineDistanceFx((xp << 16) - ax, ypay, bax, bay, lenq, lenf, rdt);
+        if (alpha <= LoAlphaFx) {
+          if (n) { pushSpan(sx, yp, fg_color, spanBg, spanAlpha, n); n = 0; }
+          continue;
+        }
+        if (n == 0) sx = xp;
+        if (alpha > HiAlphaFx) spanAlpha[n] = 255;
+        else spanAlpha[n] = (uint8_t)((alpha * 255) >> 16);
+        // Read the background of blended pixels if needed
+        if (bg_color == 0x00FFFFFF && spanAlpha[n] != 255) spanBg[n] = readPixel(xp - _xDatum, yp - _yDatum);
+        else spanBg[n] = bg_color;
+        if (++n == WEDGE_SPAN) { pushSpan(sx, yp, fg_color, spanBg, spanAlpha, n); n = 0; }
       }
-      //Blend colour with background and plot
-      if (bg_color == 0x00FFFFFF) {
-        bg = readPixel(xp, yp); swin = true;
+      if (n) pushSpan(sx, yp, fg_color, spanBg, spanAlpha, n);
+      if (i < runs) {
+        drawFastHLine(sl[i] - _xDatum, yp - _yDatum, sr[i] - sl[i] + 1, fg_color);
+        xs = sr[i] + 1;
       }
-      #ifdef GC9A01_DRIVER
-        uint16_t pcol = fastBlend((uint8_t)(alpha * PixelAlphaGain), fg_color, bg);
-        drawPixel(xp, yp, pcol);
-        swin = swin;
-      #else
-        if (swin) { setWindow(xp, yp, x1, yp); swin = false; }
-        pushColor(fastBlend((uint8_t)(alpha * PixelAlphaGain), fg_color, bg));
-      #endif
     }
   }
 
   inTransaction = lockTransaction;
   end_nin_write();
 }
+#endif
 
 
 /***************************************************************************************
@@ -2136,6 +2697,24 @@ inline float TFT_GFX::wedgeLineDistance(float xpax, float ypay, float bax, float
   return sqrtf(dx * dx + dy * dy) + h * dr;
 }
 
+/***************************************************************************************
+** Function name:           pushSpan - helper function for drawWedgeLine
+** Description:             blend a run of pixels over their backgrounds and plot them
+***************************************************************************************/
+void TFT_GFX::pushSpan(int32_t x, int32_t y, rgb_t fg_color, rgb_t *bg, const uint8_t *alpha, int32_t len)
+{
+  blendSpan888(bg, fg_color, alpha, len);
+#ifdef GC9A01_DRIVER
+  for (int32_t i = 0; i < len; i++) drawPixel(x + i, y, bg[i]);
+#else
+  // One window and one send for the run
+  uint16_t line[len];
+  for (int32_t i = 0; i < len; i++) line[i] = wire565(color24to16(bg[i]));
+  setWindow(x, y, x + len - 1, y);
+  pushPixels(line, len);
+#endif
+}
+
 
 /***************************************************************************************
 ** Function name:           drawFastVLine
@@ -2143,6 +2722,7 @@ inline float TFT_GFX::wedgeLineDistance(float xpax, float ypay, float bax, float
 ***************************************************************************************/
 void TFT_GFX::drawFastVLine(int32_t x, int32_t y, int32_t h, rgb_t color)
 {
+  BUS_STATS_API(BUS_API_FASTLINE);
   if (_vpOoB) return;
 
   x+= _xDatum;
@@ -2173,6 +2753,7 @@ void TFT_GFX::drawFastVLine(int32_t x, int32_t y, int32_t h, rgb_t color)
 ***************************************************************************************/
 void TFT_GFX::drawFastHLine(int32_t x, int32_t y, int32_t w, rgb_t color)
 {
+  BUS_STATS_API(BUS_API_FASTLINE);
   if (_vpOoB) return;
 
   x+= _xDatum;
@@ -2203,6 +2784,7 @@ void TFT_GFX::drawFastHLine(int32_t x, int32_t y, int32_t w, rgb_t color)
 ***************************************************************************************/
 void TFT_GFX::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, rgb_t color)
 {
+  BUS_STATS_API(BUS_API_FILLRECT);
   if (_vpOoB) return;
 
   x+= _xDatum;
@@ -2238,12 +2820,84 @@ void TFT_GFX::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, rgb_t color)
 }
 
 
+/***************************************************************************************
+** Function name:           fillSpans
+** Description:             draw n horizontal lines in one transaction
+***************************************************************************************/
+void TFT_GFX::fillSpans(const span_t *spans, uint16_t n, rgb_t color)
+{
+  BUS_STATS_API(BUS_API_FILLRECT);
+  if (_vpOoB || !n) return;
+
+  begin_tft_write();
+
+  for (const span_t *s = spans; s < spans + n; s++) {
+    int32_t x = s->x + _xDatum;
+    int32_t y = s->y + _yDatum;
+    int32_t w = s->w;
+
+    // Clipping, as drawFastHLine()
+    if ((y < _vpY) || (x >= _vpW) || (y >= _vpH)) continue;
+
+    if (x < _vpX) { w += x - _vpX; x = _vpX; }
+
+    if ((x + w) > _vpW) w = _vpW - x;
+
+    if (w < 1) continue;
+
+    setWindow(x, y, x + w - 1, y);
+
+    pushBlock(color, w);
+  }
+
+  end_tft_write();
+}
+
+
+/***************************************************************************************
+** Function name:           fillRects
+** Description:             draw n filled rectangles in one transaction
+***************************************************************************************/
+void TFT_GFX::fillRects(const rect_t *rects, uint16_t n, rgb_t color)
+{
+  BUS_STATS_API(BUS_API_FILLRECT);
+  if (_vpOoB || !n) return;
+
+  begin_tft_write();
+
+  for (const rect_t *r = rects; r < rects + n; r++) {
+    int32_t x = r->x + _xDatum;
+    int32_t y = r->y + _yDatum;
+    int32_t w = r->w;
+    int32_t h = r->h;
+
+    // Clipping, as fillRect()
+    if ((x >= _vpW) || (y >= _vpH)) continue;
+
+    if (x < _vpX) { w += x - _vpX; x = _vpX; }
+    if (y < _vpY) { h += y - _vpY; y = _vpY; }
+
+    if ((x + w) > _vpW) w = _vpW - x;
+    if ((y + h) > _vpH) h = _vpH - y;
+
+    if ((w < 1) || (h < 1)) continue;
+
+    setWindow(x, y, x + w - 1, y + h - 1);
+
+    pushBlock(color, w * h);
+  }
+
+  end_tft_write();
+}
+
+
 /***************************************************************************************
 ** Function name:           fillRectVGradient
 ** Description:             draw a filled rectangle with a vertical colour gradient
 ***************************************************************************************/
 void TFT_GFX::fillRectVGradient(int16_t x, int16_t y, int16_t w, int16_t h, rgb_t color1, rgb_t color2)
 {
+  BUS_STATS_API(BUS_API_GRADIENT);
   if (_vpOoB) return;
 
   x+= _xDatum;
@@ -2260,19 +2914,37 @@ void TFT_GFX::fillRectVGradient(int16_t x, int16_t y, int16_t w, int16_t h, rgb_
 
   if ((w < 1) || (h < 1)) return;
 
-  begin_nin_write();
+  begin_tft_write();
+  inTransaction = true;
 
-  float delta = -255.0/h;
-  float alpha = 255.0;
-  rgb_t color = color1;
+  // One window, each row is one colour run
+  setWindow(x, y, x + w - 1, y + h - 1);
 
-  while (h--) {
-    drawFastHLine(x, y++, w, color);
-    alpha += delta;
-    color = fastBlend((uint8_t)alpha, color1, color2);
+  gradient_t gr;
+  gradientStart(&gr, color1, color2, h);
+
+  if (!_gradDither) {
+    while (h--) {
+      pushBlock(gradientColor(&gr), w);
+      gradientStep(&gr);
+    }
+  }
+  else {
+    // A dithered row repeats every 4 pixels
+    uint16_t lineBuf[w];
+    while (h--) {
+      for (int32_t i = 0; i < w; i++) {
+        if (i < 4) lineBuf[i] = wire565(gradient565(&gr, x + i, y, true));
+        else lineBuf[i] = lineBuf[i - 4];
+      }
+      pushPixels(lineBuf, w);
+      gradientStep(&gr);
+      y++;
+    }
   }
 
-  end_nin_write();
+  inTransaction = lockTransaction;
+  end_tft_write();
 }
 
 
@@ -2282,6 +2954,7 @@ void TFT_GFX::fillRectVGradient(int16_t x, int16_t y, int16_t w, int16_t h, rgb_
 ***************************************************************************************/
 void TFT_GFX::fillRectHGradient(int16_t x, int16_t y, int16_t w, int16_t h, rgb_t color1, rgb_t color2)
 {
+  BUS_STATS_API(BUS_API_GRADIENT);
   if (_vpOoB) return;
 
   x+= _xDatum;
@@ -2298,21 +2971,379 @@ void TFT_GFX::fillRectHGradient(int16_t x, int16_t y, int16_t w, int16_t h, rgb_
 
   if ((w < 1) || (h < 1)) return;
 
+  begin_tft_write();
+  inTransaction = true;
+
+  setWindow(x, y, x + w - 1, y + h - 1);
+
+  // The row is built once and repeated, dithered rows repeat every 4 lines
+  int32_t rows = _gradDither ? 4 : 1;
+  uint16_t lineBuf[rows * w];
+
+  for (int32_t j = 0; j < rows; j++) {
+    gradient_t gr;
+    gradientStart(&gr, color1, color2, w);
+    for (int32_t i = 0; i < w; i++) {
+      lineBuf[j * w + i] = wire565(gradient565(&gr, x + i, y + j, _gradDither));
+      gradientStep(&gr);
+    }
+  }
+
+  for (int32_t j = 0; j < h; j++) pushPixelsAsync(lineBuf + (j & (rows - 1)) * w, w);
+  pushPixelsWait();
+
+  inTransaction = lockTransaction;
+  end_tft_write();
+}
+
+
+/***************************************************************************************
+** Function name:           fillRectLinearGradient
+** Description:             draw a filled rectangle with a linear gradient at any angle
+***************************************************************************************/
+void TFT_GFX::fillRectLinearGradient(int32_t x, int32_t y, int32_t w, int32_t h, rgb_t color1, rgb_t color2, int16_t angle)
+{
+  BUS_STATS_API(BUS_API_GRADIENT);
+  if ((w < 1) || (h < 1)) return;
+
+  // Direction in Q16.16
+  int64_t c = cosDegFx(angle);
+  int64_t s = sinDegFx(angle);
+
+  // Distance from the centre of the rectangle to its furthest corner along the gradient
+  int64_t e = ((w - 1) * (c < 0 ? -c : c) + (h - 1) * (s < 0 ? -s : s)) / 2;
+  if (e < 32768) e = 32768;
+
+  // Position 0 to 65535 along the gradient, stepped per pixel in x and y
+  gradfill_t g;
+  g.type = GRAD_LINEAR;
+  g.color1 = color1;
+  g.color2 = color2;
+  g.tx = (int32_t)(c * 32768 / e);
+  g.ty = (int32_t)(s * 32768 / e);
+  g.t0 = (int32_t)(32768 - ((2 * x + w - 1) * c + (2 * y + h - 1) * s) * 16384 / e);
+
+  fillGradient(x, y, w, h, &g);
+}
+
+/***************************************************************************************
+** Function name:           fillRadialGradient
+** Description:             draw a filled rectangle with a radial gradient
+***************************************************************************************/
+void TFT_GFX::fillRadialGradient(int32_t x, int32_t y, int32_t w, int32_t h, int32_t cx, int32_t cy, int32_t r,
+                                 rgb_t color1, rgb_t color2)
+{
+  BUS_STATS_API(BUS_API_GRADIENT);
+  if ((w < 1) || (h < 1)) return;
+
+  gradfill_t g;
+  g.type = GRAD_RADIAL;
+  g.color1 = color1;
+  g.color2 = color2;
+  g.cx = cx;
+  g.cy = cy;
+  g.r16 = r < 1 ? 16 : r * 16;
+
+  fillGradient(x, y, w, h, &g);
+}
+
+/***************************************************************************************
+** Function name:           fillConicGradient
+** Description:             draw a filled rectangle with a conic (sweep) gradient
+***************************************************************************************/
+void TFT_GFX::fillConicGradient(int32_t x, int32_t y, int32_t w, int32_t h, int32_t cx, int32_t cy,
+                                uint16_t startAngle, uint16_t endAngle, rgb_t color1, rgb_t color2)
+{
+  BUS_STATS_API(BUS_API_GRADIENT);
+  if ((w < 1) || (h < 1)) return;
+
+  startAngle %= 360;
+  endAngle %= 360;
+  if (endAngle <= startAngle) endAngle += 360;
+
+  gradfill_t g;
+  g.type = GRAD_CONIC;
+  g.color1 = color1;
+  g.color2 = color2;
+  g.cx = cx;
+  g.cy = cy;
+  g.start = (uint16_t)(((uint32_t)startAngle << 16) / 360);
+  g.sweep = ((uint32_t)(endAngle - startAngle) << 16) / 360;
+
+  fillGradient(x, y, w, h, &g);
+}
+
+/***************************************************************************************
+** Function name:           fillGradient
+** Description:             fill a rectangle with a gradient through one window
+***************************************************************************************/
+void TFT_GFX::fillGradient(int32_t x, int32_t y, int32_t w, int32_t h, const gradfill_t *g)
+{
+  if (_vpOoB) return;
+
+  int32_t gx = x, gy = y; // Gradient coordinates of the first pixel
+
+  x+= _xDatum;
+  y+= _yDatum;
+
+  // Clipping
+  if ((x >= _vpW) || (y >= _vpH)) return;
+
+  if (x < _vpX) { gx += _vpX - x; w += x - _vpX; x = _vpX; }
+  if (y < _vpY) { gy += _vpY - y; h += y - _vpY; y = _vpY; }
+
+  if ((x + w) > _vpW) w = _vpW - x;
+  if ((y + h) > _vpH) h = _vpH - y;
+
+  if ((w < 1) || (h < 1)) return;
+
+  // Colours along the gradient, in wire order
+  uint16_t ramp[256];
+  gradientRamp(ramp, g->color1, g->color2);
+  for (int32_t i = 0; i < 256; i++) ramp[i] = wire565(ramp[i]);
+
+  begin_tft_write();
+  inTransaction = true;
+
+  setWindow(x, y, x + w - 1, y + h - 1);
+
+  // A line is computed while the one before is sent
+  uint32_t  lineMem[TFT_LINE_WORDS(w)];
+  uint16_t* lineBuf = lineBuffers(lineMem, w);
+
+  while (h--) {
+    gradientLine(lineBuf, ramp, gx, gy++, w, g);
+    lineBuf = pushLineBuffered(lineBuf, w);
+  }
+  pushPixelsWait();
+
+  inTransaction = lockTransaction;
+  end_tft_write();
+}
+
+// atan(i / 256) for i = 0 to 256, 65536 per turn, built on first use
+static uint16_t atanLut[257];
+static bool     atanValid = false;
+
+// Angle clockwise from 6 o'clock of dx, dy from the centre, 65536 per turn
+static uint16_t conicAngle(int32_t dx, int32_t dy)
+{
+  if (!atanValid) {
+    for (int32_t i = 0; i <= 256; i++) atanLut[i] = (uint16_t)(atanf(i / 256.0f) * 32768.0f / 3.14159265f + 0.5f);
+    atanValid = true;
+  }
+
+  // atan2(-dx, dy)
+  int32_t a = -dx, b = dy;
+  uint32_t aa = a < 0 ? -a : a;
+  uint32_t ab = b < 0 ? -b : b;
+  if (!aa && !ab) return 0;
+
+  uint16_t t; // First quadrant, 0 to 16384
+  if (aa <= ab) t = atanLut[(aa << 8) / ab];
+  else t = 16384 - atanLut[(ab << 8) / aa];
+
+  if (b < 0) t = 32768 - t;
+  if (a < 0) t = -t;
+  return t;
+}
+
+/***************************************************************************************
+** Function name:           fillArcGradient
+** Description:             fill an arc with a conic gradient around its centre
+***************************************************************************************/
+void TFT_GFX::fillArcGradient(int32_t x, int32_t y, int32_t r, int32_t ir, uint16_t startAngle, uint16_t endAngle,
+                              rgb_t color1, rgb_t color2, rgb_t bg_color)
+{
+  BUS_STATS_API(BUS_API_GRADIENT);
+  if (_vpOoB) return;
+  if (r < ir) transpose(r, ir);  // Required that r > ir
+  if (r <= 0 || ir < 0) return;  // Invalid r, ir can be zero (circle sector)
+
+  startAngle %= 360;
+  endAngle %= 360;
+  if (endAngle <= startAngle) endAngle += 360;
+
+  gradfill_t g;
+  g.type = GRAD_CONIC;
+  g.color1 = color1;
+  g.color2 = color2;
+  g.cx = x;
+  g.cy = y;
+  g.start = (uint16_t)(((uint32_t)startAngle << 16) / 360);
+  g.sweep = ((uint32_t)(endAngle - startAngle) << 16) / 360;
+
+  uint16_t ramp[256];
+  gradientRamp(ramp, color1, color2);
+
+  span_t   batch[SPAN_BATCH];
+  uint16_t count = 0;
+
   begin_nin_write();
+  inTransaction = true;
+
+  // Pixels with ir^2 <= dx^2 + dy^2 <= r^2 as drawArc() fills, clipped to the sweep
+  int32_t r2 = r * r, r3 = ir * ir;
+  // Anti-aliased fringe out to r + 1 and in to ir - 1, blended as drawArc() does
+  int32_t r1 = (r + 1) * (r + 1), r4 = ir > 0 ? (ir - 1) * (ir - 1) : 0;
+  for (int32_t dy = -r; dy <= r; dy++) {
+    int32_t o2 = r2 - dy * dy, i2 = r3 - dy * dy;
+
+    // Outer and inner half widths of the row
+    int32_t xo = (int32_t)sqrtf((float)o2);
+    while ((xo + 1) * (xo + 1) <= o2) xo++;
+    while (xo * xo > o2) xo--;
+    int32_t xi = 0;
+    if (i2 > 0) {
+      xi = (int32_t)sqrtf((float)i2);
+      while (xi * xi < i2) xi++;
+      while (xi > 0 && (xi - 1) * (xi - 1) >= i2) xi--;
+    }
+
+    // Half widths of the fringe, beyond xo and inside xi
+    int32_t xf = xo;
+    while ((xf + 1) * (xf + 1) + dy * dy < r1) xf++;
+    int32_t xn = xi;
+    while (xn > 0 && (xn - 1) * (xn - 1) + dy * dy > r4) xn--;
+
+    int32_t fringe[4][2] = { { -xf, -xo - 1 }, { xo + 1, xf }, { -xi + 1, -xn }, { xn ? xn : 1, xi - 1 } };
+    for (int32_t k = 0; k < (xi ? 4 : 2); k++) {
+      for (int32_t dx = fringe[k][0]; dx <= fringe[k][1]; dx++) {
+        if (g.sweep < 0x10000 && (uint16_t)(conicAngle(dx, dy) - g.start) >= g.sweep) continue;
+        int32_t xp = x + dx + _xDatum, yp = y + dy + _yDatum;
+        if (xp < _vpX || xp >= _vpW || yp < _vpY || yp >= _vpH) continue;
+
+        uint32_t hyp = dx * dx + dy * dy;
+        uint8_t alpha = sqrt_fraction(hyp);
+        if (k < 2) alpha = ~alpha;  // Outer fringe
+        if (alpha < 16) continue;   // Skip low alpha pixels as drawArc()
+
+        uint16_t c565;
+        gradientLine(&c565, ramp, x + dx, y + dy, 1, &g);
+        rgb_t bg = (bg_color == WHITE) ? readPixel(x + dx, y + dy) : bg_color;
+        pushSpan(xp, yp, color16to24(c565), &bg, &alpha, 1);
+      }
+    }
 
-  float delta = -255.0/w;
-  float alpha = 255.0;
-  rgb_t color = color1;
+    if (xi > xo) continue;
 
-  while (w--) {
-    drawFastVLine(x++, y, h, color);
-    alpha += delta;
-    color = fastBlend((uint8_t)alpha, color1, color2);
+    // Left and right segments, one if the row misses the hole
+    int32_t seg[2][2] = { { -xo, xi ? -xi : xo }, { xi, xo } };
+    for (int32_t k = 0; k < (xi ? 2 : 1); k++) {
+      if (g.sweep >= 0x10000) {
+        addGradientSpan(batch, &count, x + seg[k][0], y + dy, seg[k][1] - seg[k][0] + 1, ramp, &g);
+        continue;
+      }
+      // Split the segment where it leaves and enters the sweep
+      int32_t run = 0;
+      bool in = false;
+      for (int32_t dx = seg[k][0]; dx <= seg[k][1]; dx++) {
+        bool inside = (uint16_t)(conicAngle(dx, dy) - g.start) < g.sweep;
+        if (inside && !in) run = dx;
+        else if (!inside && in) addGradientSpan(batch, &count, x + run, y + dy, dx - run, ramp, &g);
+        in = inside;
+      }
+      if (in) addGradientSpan(batch, &count, x + run, y + dy, seg[k][1] + 1 - run, ramp, &g);
+    }
   }
+  if (count) fillGradientSpans(batch, count, ramp, &g);
 
+  inTransaction = lockTransaction;
   end_nin_write();
 }
 
+/***************************************************************************************
+** Function name:           fillGradientSpans
+** Description:             fill spans with a gradient, each through its own window
+***************************************************************************************/
+void TFT_GFX::fillGradientSpans(const span_t *spans, uint16_t n, const uint16_t *ramp, const gradfill_t *g)
+{
+  if (_vpOoB || !n) return;
+
+  begin_tft_write();
+  inTransaction = true;
+
+  for (const span_t *s = spans; s < spans + n; s++) {
+    int32_t gx = s->x;
+    int32_t x = s->x + _xDatum;
+    int32_t y = s->y + _yDatum;
+    int32_t w = s->w;
+
+    // Clipping, as drawFastHLine()
+    if ((y < _vpY) || (x >= _vpW) || (y >= _vpH)) continue;
+
+    if (x < _vpX) { gx += _vpX - x; w += x - _vpX; x = _vpX; }
+
+    if ((x + w) > _vpW) w = _vpW - x;
+
+    if (w < 1) continue;
+
+    uint16_t lineBuf[w];
+    gradientLine(lineBuf, ramp, gx, s->y, w, g);
+    for (int32_t i = 0; i < w; i++) lineBuf[i] = wire565(lineBuf[i]);
+
+    setWindow(x, y, x + w - 1, y);
+    pushPixels(lineBuf, w);
+  }
+
+  inTransaction = lockTransaction;
+  end_tft_write();
+}
+
+/***************************************************************************************
+** Function name:           gradientRamp
+** Description:             compute the 256 565 colours along a gradient
+***************************************************************************************/
+void TFT_GFX::gradientRamp(uint16_t *ramp, rgb_t color1, rgb_t color2)
+{
+  gradient_t gr;
+  gradientStart(&gr, color1, color2, 256);
+  for (int32_t i = 0; i < 256; i++) {
+    ramp[i] = gradient565(&gr, 0, 0, false);
+    gradientStep(&gr);
+  }
+}
+
+/***************************************************************************************
+** Function name:           gradientLine
+** Description:             compute a line of n gradient pixels from x,y
+***************************************************************************************/
+void TFT_GFX::gradientLine(uint16_t *out, const uint16_t *ramp, int32_t x, int32_t y, int32_t n, const gradfill_t *g)
+{
+  if (g->type == GRAD_LINEAR) {
+    int32_t t = g->t0 + x * g->tx + y * g->ty;
+    while (n--) {
+      int32_t i = t >> 8;
+      if (i < 0) i = 0;
+      else if (i > 255) i = 255;
+      *out++ = ramp[i];
+      t += g->tx;
+    }
+  }
+  else if (g->type == GRAD_RADIAL) {
+    // Distance in 1/16 pixels tracked from its square as x steps
+    int32_t  dx = x - g->cx, dy = y - g->cy;
+    uint32_t d2 = (uint32_t)(dx * dx + dy * dy) << 8;
+    uint32_t d  = (uint32_t)sqrtf((float)d2);
+    uint32_t k  = (255UL << 16) / g->r16;
+    while (n--) {
+      while ((d + 1) * (d + 1) <= d2) d++;
+      while (d * d > d2) d--;
+      *out++ = ramp[d >= g->r16 ? 255 : (d * k) >> 16];
+      d2 += (uint32_t)(2 * dx + 1) * 256;
+      dx++;
+    }
+  }
+  else { // GRAD_CONIC
+    int32_t  dx = x - g->cx, dy = y - g->cy;
+    uint32_t k  = (255UL << 16) / g->sweep;
+    while (n--) {
+      uint16_t a = conicAngle(dx++, dy) - g->start;
+      *out++ = ramp[a >= g->sweep ? 255 : (a * k) >> 16];
+    }
+  }
+}
+
 
 /***************************************************************************************
 ** Function name:           color565
@@ -2454,3 +3485,42 @@ rgb_t TFT_GFX::alphaBlend(uint8_t alpha, rgb_t fgc, rgb_t bgc, uint8_t dither)
   return (rxx & 0xFF0000) | (xgx & 0x00FF00) | (xxb & 0x0000FF);
 }
 
+/***************************************************************************************
+** Function name:           blendSpan565
+** Description:             Blend a constant 565 colour over a run with per pixel alpha
+***************************************************************************************/
+// The 565 pixel is spread in a 32-bit word as 00000GGGGGG00000RRRRR000000BBBBB,
+// each channel then has 5 spare bits above it and one multiply blends all three
+#define SPREAD565(c) (((uint32_t)(c) | ((uint32_t)(c) << 16)) & 0x07E0F81F)
+
+void blendSpan565(uint16_t *buf, uint16_t fgc, const uint8_t *alpha, int32_t len)
+{
+  uint32_t fg = SPREAD565(fgc);
+
+  while (len-- > 0) {
+    uint32_t a = (*alpha++ + 4) >> 3; // 0-32
+    uint32_t c = (fg * a + SPREAD565(*buf) * (32 - a)) >> 5;
+    c &= 0x07E0F81F;
+    *buf++ = (uint16_t)(c | c >> 16);
+  }
+}
+
+/***************************************************************************************
+** Function name:           blendSpan888
+** Description:             Blend a constant 24-bit colour over a run with per pixel alpha
+***************************************************************************************/
+// Red and blue are blended together in one word, 8 spare bits above each
+void blendSpan888(rgb_t *buf, rgb_t fgc, const uint8_t *alpha, int32_t len)
+{
+  uint32_t frb = fgc & 0xFF00FF;
+  uint32_t fxg = fgc & 0x00FF00;
+
+  while (len-- > 0) {
+    uint32_t a = *alpha++;
+    a += a >> 7; // 0-256
+    uint32_t rb = (frb * a + (*buf & 0xFF00FF) * (256 - a)) >> 8;
+    uint32_t xg = (fxg * a + (*buf & 0x00FF00) * (256 - a)) >> 8;
+    *buf++ = (rb & 0xFF00FF) | (xg & 0x00FF00);
+  }
+}
+
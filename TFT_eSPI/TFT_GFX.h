@@ -42,6 +42,10 @@
 **                         Section 3: Interface setup
 ***************************************************************************************/
 
+// The smooth graphics (drawSmoothArc, drawArc, drawWedgeLine, drawSpot and drawWideLine)
+// use Q16.16 fixed point maths if SMOOTH_FIXED is defined (User_Setup_Select.h), floats
+// otherwise. Measure both with TFT_Benchmark on the target before choosing fixed point.
+
 /***************************************************************************************
 **                         Section 4: Setup fonts
 ***************************************************************************************/
@@ -115,12 +119,31 @@ static const uint16_t default_4bit_palette[] PROGMEM = {
 **                         Section 8: Class member and support functions
 ***************************************************************************************/
 
+// Polygon vertex, see fillPolygon()
+typedef struct { int16_t x, y; } poly_point_t;
+
+// Horizontal run of w pixels starting at x,y, see fillSpans()
+typedef struct { int32_t x, y, w; } span_t;
+// Rectangle, see fillRects()
+typedef struct { int32_t x, y, w, h; } rect_t;
+
+// Spans or rectangles the filled primitives collect before each fillSpans() or fillRects()
+#ifndef SPAN_BATCH
+  #define SPAN_BATCH 32
+#endif
+
+// Polygon edges fillPolygon() keeps on the stack, the edge table of more is allocated
+#ifndef POLY_EDGES
+  #define POLY_EDGES 32
+#endif
+
 class TFT_GFX : public TFT_eeSPI {
 
   friend class TFT_CHAR;
   friend class TFT_Print;
   friend class TFT_eSPI;
   friend class TFT_eSprite;
+  friend class TFT_ePath;
 
 public:
   TFT_GFX();
@@ -131,14 +154,40 @@ public:
                    drawFastHLine(int32_t x, int32_t y, int32_t w, rgb_t color),
                    fillRect(int32_t x, int32_t y, int32_t w, int32_t h, rgb_t color);
 
+           // Fill n spans or n rectangles with one colour, clipped in one pass and
+           // written in one transaction. Spans with w < 1 are skipped.
+  virtual void
+           fillSpans(const span_t *spans, uint16_t n, rgb_t color),
+           fillRects(const rect_t *rects, uint16_t n, rgb_t color);
+
   // Graphics drawing
   void
            drawRect(int32_t x, int32_t y, int32_t w, int32_t h, rgb_t color),
            drawRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t radius, rgb_t color),
            fillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t radius, rgb_t color);
 
-  void     fillRectVGradient(int16_t x, int16_t y, int16_t w, int16_t h, rgb_t color1, rgb_t color2);
-  void     fillRectHGradient(int16_t x, int16_t y, int16_t w, int16_t h, rgb_t color1, rgb_t color2);
+           // Gradients from color1 at the top or left to color2 at the bottom or right
+  virtual void
+           fillRectVGradient(int16_t x, int16_t y, int16_t w, int16_t h, rgb_t color1, rgb_t color2),
+           fillRectHGradient(int16_t x, int16_t y, int16_t w, int16_t h, rgb_t color1, rgb_t color2);
+           // Ordered dither of the gradients to the 565 colour steps, reduces banding
+  void     setGradientDither(bool dither) { _gradDither = dither; }
+
+           // Linear gradient from color1 to color2 across the rectangle at any angle, in
+           // degrees clockwise, 0 = left to right, 90 = top to bottom
+  void     fillRectLinearGradient(int32_t x, int32_t y, int32_t w, int32_t h, rgb_t color1, rgb_t color2, int16_t angle);
+           // Radial gradient filling the rectangle, color1 at cx,cy to color2 at radius r and beyond
+  void     fillRadialGradient(int32_t x, int32_t y, int32_t w, int32_t h, int32_t cx, int32_t cy, int32_t r,
+                              rgb_t color1, rgb_t color2);
+           // Conic (sweep) gradient filling the rectangle, color1 at startAngle clockwise to color2
+           // at endAngle around cx,cy and color2 beyond. Angles as drawArc(), 0 = 6 o'clock.
+  void     fillConicGradient(int32_t x, int32_t y, int32_t w, int32_t h, int32_t cx, int32_t cy,
+                             uint16_t startAngle, uint16_t endAngle, rgb_t color1, rgb_t color2);
+           // Arc of drawArc() at x,y filled with the conic gradient of fillConicGradient()
+           // around x,y, e.g. a gauge scale from color1 to color2. The sides are anti-aliased
+           // with bg_color, or with the background read back if it is not given.
+  void     fillArcGradient(int32_t x, int32_t y, int32_t r, int32_t ir, uint16_t startAngle, uint16_t endAngle,
+                           rgb_t color1, rgb_t color2, rgb_t bg_color = WHITE);
 
   void     drawCircle(int32_t x, int32_t y, int32_t r, rgb_t color),
            drawCircleHelper(int32_t x, int32_t y, int32_t r, uint8_t cornername, rgb_t color),
@@ -152,6 +201,11 @@ public:
            drawTriangle(int32_t x1,int32_t y1, int32_t x2,int32_t y2, int32_t x3,int32_t y3, rgb_t color),
            fillTriangle(int32_t x1,int32_t y1, int32_t x2,int32_t y2, int32_t x3,int32_t y3, rgb_t color);
 
+           // Fill a polygon of n vertices, it may be concave or cross itself. Overlaps are
+           // filled by the even-odd rule, or by the non-zero winding rule if nonZero is set.
+           // Returns false if the edge table of more than POLY_EDGES vertices can not be allocated.
+  bool     fillPolygon(const poly_point_t *points, uint16_t n, rgb_t color, bool nonZero = false);
+
   // Smooth (anti-aliased) graphics drawing
            // Draw a pixel blended with the background pixel colour (bg_color) specified,  return blended colour
            // If the bg_color is not specified, the background pixel colour will be read from TFT or sprite
@@ -253,6 +307,65 @@ public:
 
   rgb_t    bitmap_fg, bitmap_bg;           // Bitmap foreground (bit=1) and background (bit=0) colours
 
+ protected:
+
+  bool     _gradDither;                    // Gradients dithered, see setGradientDither()
+
+  // Gradient of fillRectLinearGradient(), fillRadialGradient() or fillConicGradient()
+  enum { GRAD_LINEAR, GRAD_RADIAL, GRAD_CONIC };
+  typedef struct {
+    uint8_t  type;
+    rgb_t    color1, color2;
+    int32_t  t0, tx, ty;   // Linear: position 0-65535 at 0,0 and its steps in x and y
+    int32_t  cx, cy;       // Radial and conic: centre
+    uint32_t r16;          // Radial: radius in 1/16 pixels
+    uint16_t start;        // Conic: start angle, 65536 per turn
+    uint32_t sweep;        // Conic: angle from start to end, 1 to 65536
+  } gradfill_t;
+
+           // Fill a rectangle with the gradient, one window, a line at a time
+  virtual void fillGradient(int32_t x, int32_t y, int32_t w, int32_t h, const gradfill_t *g);
+           // Fill n spans with the gradient, ramp holds the 256 colours along it as 565
+  virtual void fillGradientSpans(const span_t *spans, uint16_t n, const uint16_t *ramp, const gradfill_t *g);
+           // Blend a run of anti-aliased pixels at x,y (datum added) over their backgrounds
+           // in bg and plot it, on the screen in one window and one pushPixels()
+  virtual void pushSpan(int32_t x, int32_t y, rgb_t fg_color, rgb_t *bg, const uint8_t *alpha, int32_t len);
+           // Compute the 256 565 colours from color1 to color2 along a gradient
+  void     gradientRamp(uint16_t *ramp, rgb_t color1, rgb_t color2);
+           // Compute n 565 pixels of the gradient from x,y, ramp holds the 256 colours along it
+  void     gradientLine(uint16_t *out, const uint16_t *ramp, int32_t x, int32_t y, int32_t n, const gradfill_t *g);
+
+           // Move the start u0,v0 of a Bresenham line, transposed if steep, to its first
+           // pixel in the viewport and u1 to its last, err is set as the loop has it there.
+           // Returns false if no pixel is in the viewport.
+  bool     clipBresenham(int32_t *u0, int32_t *v0, int32_t *u1, int32_t *err,
+                         int32_t dx, int32_t dy, int32_t vstep, bool steep);
+
+           // Add a span or rectangle to a batch of SPAN_BATCH, it is filled when full.
+           // The caller fills what is left with fillSpans() or fillRects().
+  void     addSpan(span_t *batch, uint16_t *count, int32_t x, int32_t y, int32_t w, rgb_t color)
+           {
+             if (w < 1) return;
+             span_t *s = batch + *count;
+             s->x = x; s->y = y; s->w = w;
+             if (++*count == SPAN_BATCH) { fillSpans(batch, SPAN_BATCH, color); *count = 0; }
+           }
+  void     addRect(rect_t *batch, uint16_t *count, int32_t x, int32_t y, int32_t w, int32_t h, rgb_t color)
+           {
+             if (w < 1 || h < 1) return;
+             rect_t *r = batch + *count;
+             r->x = x; r->y = y; r->w = w; r->h = h;
+             if (++*count == SPAN_BATCH) { fillRects(batch, SPAN_BATCH, color); *count = 0; }
+           }
+  void     addGradientSpan(span_t *batch, uint16_t *count, int32_t x, int32_t y, int32_t w,
+                           const uint16_t *ramp, const gradfill_t *g)
+           {
+             if (w < 1) return;
+             span_t *s = batch + *count;
+             s->x = x; s->y = y; s->w = w;
+             if (++*count == SPAN_BATCH) { fillGradientSpans(batch, SPAN_BATCH, ramp, g); *count = 0; }
+           }
+
  private:
            // Smooth graphics helper
   uint8_t  sqrt_fraction(uint32_t num);
@@ -261,6 +374,12 @@ public:
   float    wedgeLineDistance(float pax, float pay, float bax, float bay, float dr);
 
 
+#ifdef SMOOTH_FIXED
+           // drawWedgeLine with the coordinates and radii in Q16.16 fixed point
+  void     drawWedgeLineFx(int32_t ax, int32_t ay, int32_t bx, int32_t by, int32_t ar, int32_t br, rgb_t fg_color, rgb_t bg_color);
+#endif
+
+
 };
 
 // Swap any type
@@ -280,3 +399,49 @@ fastBlend(A alpha, F fgc, B bgc)
   // Recombine channels
   return (rxb & 0xF81F) | (xgx & 0x07E0);
 }
+
+// Integer gradient stepping, each channel 8.16 fixed point
+typedef struct { int32_t r, g, b, dr, dg, db; } gradient_t;
+
+// Start at c1, reaching c2 after n - 1 steps
+static inline void
+gradientStart(gradient_t* gr, rgb_t c1, rgb_t c2, int32_t n)
+{
+  int32_t d = n > 1 ? n - 1 : 1;
+  gr->r = (c1 & 0xFF0000);
+  gr->g = (c1 & 0x00FF00) << 8;
+  gr->b = (c1 & 0x0000FF) << 16;
+  gr->dr = ((int32_t)(c2 & 0xFF0000) - gr->r) / d;
+  gr->dg = ((int32_t)(c2 & 0x00FF00) * 256 - gr->g) / d;
+  gr->db = ((int32_t)(c2 & 0x0000FF) * 65536 - gr->b) / d;
+}
+
+static inline void
+gradientStep(gradient_t* gr) { gr->r += gr->dr; gr->g += gr->dg; gr->b += gr->db; }
+
+// Colour of the step, rounded
+static inline rgb_t
+gradientColor(const gradient_t* gr)
+{
+  return ((gr->r + 0x8000) >> 16) << 16 | ((gr->g + 0x8000) >> 16) << 8 | ((gr->b + 0x8000) >> 16);
+}
+
+// 565 colour of the step, with a 4x4 ordered dither by position if dither is set
+static inline uint16_t
+gradient565(const gradient_t* gr, int32_t x, int32_t y, bool dither)
+{
+  static const uint8_t bayer[16] = { 0, 8, 2, 10, 12, 4, 14, 6, 3, 11, 1, 9, 15, 7, 13, 5 };
+  // Threshold 0-15 sixteenths of one 565 step, 8 levels of red and blue, 4 of green
+  uint32_t t = dither ? bayer[(y & 3) << 2 | (x & 3)] : 0;
+  uint32_t r = (gr->r + (t << 15)) >> 19; if (r > 31) r = 31;
+  uint32_t g = (gr->g + (t << 14)) >> 18; if (g > 63) g = 63;
+  uint32_t b = (gr->b + (t << 15)) >> 19; if (b > 31) b = 31;
+  return r << 11 | g << 5 | b;
+}
+
+// Span alpha blending, buf holds the background pixels and receives the result.
+// alpha = 0 leaves the background, alpha = 255 gives the foreground exactly.
+           // 16-bit 565 colours, constant foreground with an alpha per pixel
+void       blendSpan565(uint16_t *buf, uint16_t fgc, const uint8_t *alpha, int32_t len);
+           // 24-bit colours, constant foreground with an alpha per pixel
+void       blendSpan888(rgb_t *buf, rgb_t fgc, const uint8_t *alpha, int32_t len);
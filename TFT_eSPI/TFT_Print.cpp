@@ -205,6 +205,7 @@ int16_t TFT_Print::textWidth(const char *string, uint8_t font)
 // Without font number, uses font set by setTextFont()
 int16_t TFT_Print::drawString(const String& string, int32_t poX, int32_t poY)
 {
+  BUS_STATS_API(BUS_API_DRAWSTRING);
   int16_t len = string.length() + 2;
   char buffer[len];
   string.toCharArray(buffer, len);
@@ -213,6 +214,7 @@ int16_t TFT_Print::drawString(const String& string, int32_t poX, int32_t poY)
 // With font number
 int16_t TFT_Print::drawString(const String& string, int32_t poX, int32_t poY, uint8_t font)
 {
+  BUS_STATS_API(BUS_API_DRAWSTRING);
   int16_t len = string.length() + 2;
   char buffer[len];
   string.toCharArray(buffer, len);
@@ -222,12 +224,14 @@ int16_t TFT_Print::drawString(const String& string, int32_t poX, int32_t poY, ui
 // Without font number, uses font set by setTextFont()
 int16_t TFT_Print::drawString(const char *string, int32_t poX, int32_t poY)
 {
+  BUS_STATS_API(BUS_API_DRAWSTRING);
   return drawString(string, poX, poY, textfont);
 }
 
 // With font number. Note: font number is over-ridden if a smooth font is loaded
 int16_t TFT_Print::drawString(const char *string, int32_t poX, int32_t poY, uint8_t font)
 {
+  BUS_STATS_API(BUS_API_DRAWSTRING);
   int16_t sumX = 0;
   uint8_t padding = 1, baseline = 0;
   uint16_t cwidth = textWidth(string, font); // Find the pixel width of the string in the font
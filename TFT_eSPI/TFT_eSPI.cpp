@@ -52,6 +52,10 @@
 
 inline void pushBlock(rgb_t color, int32_t len)
 {
+  SHADOW_FILL(color, len);
+  SHADOW_DEFER();
+  BUS_STATS_PIXELS(len);
+  WINDOW_PIXELS(len);
   tft_sendMDTColor(mdt_color(color), len);
 }
 
@@ -335,6 +339,18 @@ void TFT_eSPI::getSetup(setup_t &tft_settings)
 
 #include "Extensions/Sprite.cpp"
 
+#ifdef DISPLAY_LIST
+  #include "Extensions/Display_list.cpp"  // Loaded if DISPLAY_LIST is defined by user
+#endif
+
+#ifdef STRIP_RENDER
+  #include "Extensions/Strip_render.cpp"  // Loaded if STRIP_RENDER is defined by user
+#endif
+
+#ifdef SMOOTH_PATH
+  #include "Extensions/Smooth_path.cpp"  // Loaded if SMOOTH_PATH is defined by user
+#endif
+
 #ifdef AA_GRAPHICS
   #include "Extensions/AA_graphics.cpp"  // Loaded if SMOOTH_FONT is defined by user
 #endif
@@ -140,7 +140,7 @@ class TFT_eSPI : public TFT_Print {
 
   TFT_eSPI();
 
-  void init() { begin(); }
+  void init() { WINDOW_INVALIDATE(); begin(); }
 
   // Image rendering
 
@@ -165,6 +165,14 @@ class TFT_eSPI : public TFT_Print {
   int16_t  _xPivot;   // TFT x pivot point coordinate for rotated Sprites
   int16_t  _yPivot;   // TFT x pivot point coordinate for rotated Sprites
 
+/***************************************************************************************
+**                         Section 9: TFT_eSPI class conditional extensions
+***************************************************************************************/
+// Load the deferred drawing extension
+#ifdef DISPLAY_LIST
+  #include "Extensions/Display_list.h"  // Loaded if DISPLAY_LIST is defined by user
+#endif
+
 }; // End of class TFT_eSPI
 
 /***************************************************************************************
@@ -175,3 +183,11 @@ class TFT_eSPI : public TFT_Print {
 
 // Load the Sprite Class
 #include "Extensions/Sprite.h"
+
+#ifdef STRIP_RENDER
+  #include "Extensions/Strip_render.h"  // Loaded if STRIP_RENDER is defined by user
+#endif
+
+#ifdef SMOOTH_PATH
+  #include "Extensions/Smooth_path.h"  // Loaded if SMOOTH_PATH is defined by user
+#endif
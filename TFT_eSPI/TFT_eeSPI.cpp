@@ -28,27 +28,117 @@
 #include "TFT_eeSPI.h"
 #include <TFT_API.h>
 
+#ifdef TFT_SHADOW
+
+tft_shadow_t tft_shadow;
+
+/***************************************************************************************
+** Function name:           shadowColor
+** Description:             convert a colour to a shadow pixel
+***************************************************************************************/
+static inline shadow_t shadowColor565(uint16_t c)
+{
+#if TFT_SHADOW_DEPTH == 8
+  return (c & 0xE000)>>8 | (c & 0x0700)>>6 | (c & 0x0018)>>3;
+#else
+  return c;
+#endif
+}
+
+static inline shadow_t shadowColor(rgb_t color)
+{
+  return shadowColor565(((color >> 8) & 0xF800) | ((color >> 5) & 0x07E0) | ((color >> 3) & 0x001F));
+}
+
+/***************************************************************************************
+** Function name:           shadow565
+** Description:             565 colour of a shadow pixel, or of the one at screen x,y
+***************************************************************************************/
+static inline uint16_t shadowTo565(shadow_t c)
+{
+#if TFT_SHADOW_DEPTH == 8
+  static const uint8_t blue[] = {0, 11, 21, 31};
+  return (c & 0xE0)<<8 | (c & 0xC0)<<5 | (c & 0x1C)<<6 | (c & 0x1C)<<3 | blue[c & 0x03];
+#else
+  return c;
+#endif
+}
+
+static inline uint16_t shadow565(int32_t x, int32_t y)
+{
+  return shadowTo565(tft_shadow.buf[x + y * tft_shadow.width]);
+}
+
+#endif
+
 /***************************************************************************************
 ** Function name:           pushBlock
 ** Description:             TFT_eSPI_light: added for compatibility
 ***************************************************************************************/
 inline void pushBlock(rgb_t color, int32_t len)
 {
+  SHADOW_FILL(color, len);
+  SHADOW_DEFER();
+  BUS_STATS_PIXELS(len);
+  WINDOW_PIXELS(len);
   tft_sendMDTColor(mdt_color(color), len);
 }
 
+#if !defined(COLOR_565)
+
+// Pixels expanded per tft_sendMDTBuffer16() call, 3 bytes each on the stack
+#ifndef PUSH_666_PIXELS
+  #define PUSH_666_PIXELS 64
+#endif
+
+// 565 component to 8-bit R, G, B as rgb() expands them, built on first use
+static uint8_t red565[32], green565[64], blue565[32];
+static bool    lut565 = false;
+
+static void makeLut565(void)
+{
+  for (uint16_t i = 0; i < 64; i++) {
+    if (i < 32) {
+      red565[i]  = rgb(i << 11) >> 16;
+      blue565[i] = rgb(i);
+    }
+    green565[i] = rgb(i << 5) >> 8;
+  }
+  lut565 = true;
+}
+#endif
+
 /***************************************************************************************
 ** Function name:           pushPixels
 ** Description:             TFT_eSPI_light: added for compatibility
 ***************************************************************************************/
 void TFT_eeSPI::pushPixels(const uint16_t* data, int32_t len)
 {
+  SHADOW_PIXELS(data, len);
+  SHADOW_DEFER();
+  BUS_STATS_PIXELS(len);
+  WINDOW_PIXELS(len);
 #if defined(COLOR_565)
   tft_sendMDTBuffer16((const uint8_t*)data, len);
 #else
-  for (int i = 0; i < len; ++i) {
-    tft_sendMDTColor(rgb(data[i]) & 0xffffff);
+  // Expand runs of pixels to R, G, B bytes, the byte send takes them two at a time,
+  // so an even number of pixels goes in each call and an odd last one on its own
+  if (!lut565) makeLut565();
+
+  uint8_t buf[PUSH_666_PIXELS * 3];
+  while (len > 1) {
+    int32_t n = (len < PUSH_666_PIXELS ? len : PUSH_666_PIXELS) & ~1;
+    uint8_t* p = buf;
+    for (int32_t i = 0; i < n; i++) {
+      uint16_t c = *data++;
+      *p++ = red565[c >> 11];
+      *p++ = green565[(c >> 5) & 0x3F];
+      *p++ = blue565[c & 0x1F];
+    }
+    tft_sendMDTBuffer16(buf, n * 3 / 2);
+    len -= n;
   }
+  if (len) tft_sendMDTColor(rgb(*data) & 0xffffff);
 #endif
 }
 
@@ -58,16 +148,18 @@ void TFT_eeSPI::pushPixels(const uint16_t* data, int32_t len)
 ** Description:             Start SPI transaction for writes and select TFT
 ***************************************************************************************/
 inline void TFT_eeSPI::begin_tft_write(void){
-  if (locked) {
+  if (locked && !SHADOW_DEFERRED()) { // No transaction while nothing is sent
     locked = false; // Flag to show SPI access now unlocked
+    BUS_STATS_TRANSACTION();
     tft_startWrite();
   }
 }
 
 // Non-inlined version to permit override
 void TFT_eeSPI::begin_nin_write(void){
-  if (locked) {
+  if (locked && !SHADOW_DEFERRED()) { // No transaction while nothing is sent
     locked = false; // Flag to show SPI access now unlocked
+    BUS_STATS_TRANSACTION();
     tft_startWrite();
   }
 }
@@ -79,8 +171,12 @@ void TFT_eeSPI::begin_nin_write(void){
 inline void TFT_eeSPI::end_tft_write(void){
   if(!inTransaction) {      // Flag to stop ending transaction during multiple graphics calls
     if (!locked) {          // Locked when beginTransaction has been called
+#ifdef TFT_AUTO_BATCH
+      batchTime = micros(); // Left open for the next call, see endBatch()
+#else
       locked = true;        // Flag to show SPI access now locked
       tft_endWrite();
+#endif
     }
   }
 }
@@ -89,12 +185,27 @@ inline void TFT_eeSPI::end_tft_write(void){
 inline void TFT_eeSPI::end_nin_write(void){
   if(!inTransaction) {      // Flag to stop ending transaction during multiple graphics calls
     if (!locked) {          // Locked when beginTransaction has been called
+#ifdef TFT_AUTO_BATCH
+      batchTime = micros(); // Left open for the next call, see endBatch()
+#else
       locked = true;        // Flag to show SPI access now locked
       tft_endWrite();
+#endif
     }
   }
 }
 
+/***************************************************************************************
+** Function name:           begin_tft_read
+** Description:             Prepare the bus for a read
+***************************************************************************************/
+inline void TFT_eeSPI::begin_tft_read(void){
+  WINDOW_INVALIDATE();
+#ifdef TFT_AUTO_BATCH
+  endBatch(); // Reading switches the protocol
+#endif
+}
+
 /***************************************************************************************
 ** Function name:           setViewport
 ** Description:             Set the clipping region for the TFT screen
@@ -370,6 +481,10 @@ TFT_eeSPI::TFT_eeSPI() : SnakeStamp()
   locked = true;           // Transaction mutex lock flag to ensure begin/endTranaction pairing
   inTransaction = false;   // Flag to prevent multiple sequential functions to keep bus access open
   lockTransaction = false; // start/endWrite lock flag to allow sketch to keep SPI bus access open
+#ifdef TFT_AUTO_BATCH
+  batchIdle = TFT_BATCH_IDLE_US;
+  batchTime = 0;
+#endif
 }
 
 /***************************************************************************************
@@ -386,10 +501,81 @@ rgb_t TFT_eeSPI::readPixel(int32_t x0, int32_t y0)
   // Range checking
   if ((x0 < _vpX) || (y0 < _vpY) ||(x0 >= _vpW) || (y0 >= _vpH)) return BLACK;
 
+#ifdef TFT_SHADOW
+  // No bus access, the shadow holds what was sent
+  if (shadowFits()) return rgb(shadow565(x0, y0));
+#endif
+
+  BUS_STATS_API(BUS_API_READPIXEL);
+  BUS_STATS_READ();
+  begin_tft_read();
   return innerReadPixel(x0, y0);
 }
 
 
+/***************************************************************************************
+** Function name:           pushPixelsAsync
+** Description:             start sending pixels, the send before it is waited for
+***************************************************************************************/
+// A protocol offers the asynchronous send by defining TFT_SEND_ASYNC and providing
+// tft_sendMDTBuffer16Async() and tft_sendWait(), e.g. with a DMA channel. None of the
+// RP2040 protocols does yet, only the host virtual panel, which sends from a thread.
+void TFT_eeSPI::pushPixelsAsync(const uint16_t* data, int32_t len)
+{
+#if defined(COLOR_565) && defined(TFT_SEND_ASYNC)
+  SHADOW_PIXELS(data, len);
+  SHADOW_DEFER();
+  BUS_STATS_PIXELS(len);
+  WINDOW_PIXELS(len);
+  tft_sendWait();
+  tft_sendMDTBuffer16Async((const uint8_t*)data, len);
+#else
+  pushPixels(data, len);
+#endif
+}
+
+/***************************************************************************************
+** Function name:           pushPixelsWait
+** Description:             wait until the pixels of pushPixelsAsync() have been sent
+***************************************************************************************/
+void TFT_eeSPI::pushPixelsWait(void)
+{
+#if defined(COLOR_565) && defined(TFT_SEND_ASYNC)
+  tft_sendWait();
+#endif
+}
+
+
+/***************************************************************************************
+** Function name:           lineBuffers
+** Description:             take the memory of the line buffers, returns the first line
+***************************************************************************************/
+uint16_t* TFT_eeSPI::lineBuffers(uint32_t* mem, int32_t len)
+{
+#if TFT_LINE_BUFFERS > 1
+  _lineAlt = (uint16_t*)(mem + ((len + 1) >> 1));
+#endif
+  return (uint16_t*)mem;
+}
+
+/***************************************************************************************
+** Function name:           pushLineBuffered
+** Description:             send a line, returns the line to fill next
+***************************************************************************************/
+uint16_t* TFT_eeSPI::pushLineBuffered(uint16_t* line, int32_t len)
+{
+  pushPixelsAsync(line, len);
+#if TFT_LINE_BUFFERS > 1
+  uint16_t* next = _lineAlt;
+  _lineAlt = line;
+  return next;
+#else
+  // Sent before pushPixelsAsync() returns, the line can be filled again
+  return line;
+#endif
+}
+
+
 /***************************************************************************************
 ** Function name:           setSwapBytes
 ** Description:             Used by 16-bit pushImage() to swap byte order in colours
@@ -432,6 +618,35 @@ void TFT_eeSPI::setAddrWindow(int32_t x0, int32_t y0, int32_t w, int32_t h)
 // Chip select stays low, call begin_tft_write first. Use setAddrWindow() from sketches
 void TFT_eeSPI::setWindow(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
 {
+  // Deferred, the panel window is set by flushShadow()
+  if (SHADOW_DEFERRED()) { SHADOW_WINDOW(x0, y0, x1, y1); return; }
+
+#ifdef TFT_WINDOW_CACHE
+  bool sameX = tft_window.valid && x0 == tft_window.xs && x1 == tft_window.xe;
+  bool sameY = tft_window.valid && y0 == tft_window.ys && y1 == tft_window.ye;
+
+  // Inside the window on the panel, whose write pointer is at the start of row y0
+  if (sameX && y0 >= tft_window.ys && y1 <= tft_window.ye)
+  {
+    uint32_t w = x1 - x0 + 1;
+    uint32_t area = w * (tft_window.ye - tft_window.ys + 1);
+    if (tft_window.ptr % area == (uint32_t)(y0 - tft_window.ys) * w) return;
+  }
+
+  tft_window.xs = x0;
+  tft_window.ys = y0;
+  tft_window.xe = x1;
+  tft_window.ye = y1;
+  tft_window.ptr = 0;
+  tft_window.valid = true;
+#endif
+  BUS_STATS_WINDOW();
+  SHADOW_WINDOW(x0, y0, x1, y1);
+#if defined(TFT_WINDOW_CACHE) && defined(TFT_WRITE_ADDR_AXES)
+  // One axis is already on the panel, send only the other one
+  if (sameX) { tft_writeAddrRows(y0, y1 - y0 + 1); return; }
+  if (sameY) { tft_writeAddrColumns(x0, x1 - x0 + 1); return; }
+#endif
   tft_writeAddrWindow(x0, y0, x1 - x0 + 1, y1 - y0 + 1);
 }
 
@@ -442,9 +657,15 @@ void TFT_eeSPI::setWindow(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
 ***************************************************************************************/
 void TFT_eeSPI::pushColor(rgb_t color)
 {
+  BUS_STATS_API(BUS_API_PUSHCOLOR);
   begin_tft_write();
 
-  tft_sendMDTColor(mdt_color(color));
+  SHADOW_FILL(color, 1);
+  if (!SHADOW_DEFERRED()) {
+    BUS_STATS_PIXELS(1);
+    WINDOW_PIXELS(1);
+    tft_sendMDTColor(mdt_color(color));
+  }
 
   end_tft_write();
 }
@@ -456,6 +677,7 @@ void TFT_eeSPI::pushColor(rgb_t color)
 ***************************************************************************************/
 void TFT_eeSPI::pushColor(rgb_t color, int32_t len)
 {
+  BUS_STATS_API(BUS_API_PUSHCOLOR);
   begin_tft_write();
 
   pushBlock(color, len);
@@ -484,8 +706,36 @@ void TFT_eeSPI::endWrite(void)
   inTransaction = false;
 //  DMA_BUSY_CHECK;          // Safety check - user code should have checked this!
   end_tft_write();         // Release SPI bus
+#ifdef TFT_AUTO_BATCH
+  endBatch();              // Only the drawing calls leave the transaction open
+#endif
 }
 
+#ifdef TFT_AUTO_BATCH
+/***************************************************************************************
+** Function name:           endBatch
+** Description:             end the transaction left open by the drawing calls
+***************************************************************************************/
+void TFT_eeSPI::endBatch(void)
+{
+  // Not inside startWrite()/endWrite() or a drawing call
+  if (!locked && !inTransaction) {
+    locked = true;
+    tft_endWrite();
+  }
+}
+
+/***************************************************************************************
+** Function name:           pollBatch
+** Description:             end the open transaction if idle, true if there is none
+***************************************************************************************/
+bool TFT_eeSPI::pollBatch(void)
+{
+  if (!locked && !inTransaction && (uint32_t)(micros() - batchTime) >= batchIdle) endBatch();
+  return locked;
+}
+#endif
+
 /***************************************************************************************
 ** Function name:           writeColor (use startWrite() and endWrite() before & after)
 ** Description:             raw write of "len" pixels avoiding transaction check
@@ -503,6 +753,7 @@ void TFT_eeSPI::writeColor(rgb_t color, int32_t len)
 // len is number of bytes, not pixels
 void TFT_eeSPI::pushColors(uint8_t *data, int32_t len)
 {
+  BUS_STATS_API(BUS_API_PUSHCOLOR);
   begin_tft_write();
 
   pushPixels((uint16_t*)data, len>>1);
@@ -517,6 +768,7 @@ void TFT_eeSPI::pushColors(uint8_t *data, int32_t len)
 ***************************************************************************************/
 void TFT_eeSPI::pushColors(uint16_t *data, int32_t len, bool swap)
 {
+  BUS_STATS_API(BUS_API_PUSHCOLOR);
   begin_tft_write();
   if (swap) {swap = _swapBytes; _swapBytes = true; }
 
@@ -526,3 +778,499 @@ void TFT_eeSPI::pushColors(uint16_t *data, int32_t len, bool swap)
   end_tft_write();
 }
 
+
+#ifdef TFT_WINDOW_CACHE
+
+tft_window_t tft_window;
+
+#endif
+
+#ifdef TFT_SHADOW
+
+/***************************************************************************************
+** Function name:           shadowWindow
+** Description:             set the window the next pixels are stored in
+***************************************************************************************/
+void shadowWindow(int32_t xs, int32_t ys, int32_t xe, int32_t ye)
+{
+  tft_shadow.xs = tft_shadow.x = xs;
+  tft_shadow.ys = tft_shadow.y = ys;
+  tft_shadow.xe = xe;
+  tft_shadow.ye = ye;
+}
+
+/***************************************************************************************
+** Function name:           shadowMark
+** Description:             mark the tiles of x0 to x1 on screen row y, or test one
+***************************************************************************************/
+static void shadowMark(int32_t x0, int32_t x1, int32_t y)
+{
+  int32_t i = (y / TFT_SHADOW_TILE) * tft_shadow.tilesX + x0 / TFT_SHADOW_TILE;
+  int32_t e = i + (x1 / TFT_SHADOW_TILE - x0 / TFT_SHADOW_TILE);
+  for (; i <= e; i++) tft_shadow.dirty[i >> 3] |= 1 << (i & 7);
+}
+
+static inline bool shadowDirty(int32_t i)
+{
+  return tft_shadow.dirty[i >> 3] & (1 << (i & 7));
+}
+
+/***************************************************************************************
+** Function name:           shadowRun
+** Description:             take the pixels from the write pointer to the window edge
+***************************************************************************************/
+// Returns how many of len pixels fit in the window row, they are stored at base + i for
+// lo <= i < hi, the part inside the screen. The write pointer is moved past them and
+// wraps like the panel: to the next row at the window edge, to the top at its end.
+static int32_t shadowRun(int32_t len, int32_t *base, int32_t *lo, int32_t *hi)
+{
+  tft_shadow_t *s = &tft_shadow;
+  int32_t n = s->xe - s->x + 1;
+  if (n > len || n < 1) n = len;
+
+  *base = s->x + s->y * s->width;
+  *lo = 0;
+  *hi = n;
+  if (s->y < 0 || s->y >= s->height) *hi = 0;
+  else {
+    if (s->x < 0) *lo = -s->x;
+    if (s->x + n > s->width) *hi = s->width - s->x;
+    if (s->defer && *lo < *hi) shadowMark(s->x + *lo, s->x + *hi - 1, s->y);
+  }
+
+  s->x += n;
+  if (s->x > s->xe) {
+    s->x = s->xs;
+    if (++s->y > s->ye) s->y = s->ys;
+  }
+  return n;
+}
+
+/***************************************************************************************
+** Function name:           shadowFill
+** Description:             store len pixels of one colour at the write pointer
+***************************************************************************************/
+void shadowFill(rgb_t color, int32_t len)
+{
+  if (!tft_shadow.buf) return;
+
+  shadow_t c = shadowColor(color);
+  while (len > 0) {
+    int32_t base, lo, hi;
+    len -= shadowRun(len, &base, &lo, &hi);
+    for (int32_t i = lo; i < hi; i++) tft_shadow.buf[base + i] = c;
+  }
+}
+
+/***************************************************************************************
+** Function name:           shadowPixels
+** Description:             store the 565 pixels pushPixels() sends
+***************************************************************************************/
+void shadowPixels(const uint16_t *data, int32_t len)
+{
+  if (!tft_shadow.buf) return;
+
+  while (len > 0) {
+    int32_t base, lo, hi;
+    int32_t n = shadowRun(len, &base, &lo, &hi);
+    for (int32_t i = lo; i < hi; i++) {
+#if defined(COLOR_565)
+      // Sent as they are in memory, high byte first
+      const uint8_t *p = (const uint8_t *)(data + i);
+      tft_shadow.buf[base + i] = shadowColor565(p[0] << 8 | p[1]);
+#else
+      tft_shadow.buf[base + i] = shadowColor565(data[i]);
+#endif
+    }
+    data += n;
+    len -= n;
+  }
+}
+
+/***************************************************************************************
+** Function name:           shadowPixel
+** Description:             store a pixel drawn outside the window, at screen x,y
+***************************************************************************************/
+void shadowPixel(int32_t x, int32_t y, rgb_t color)
+{
+  if (!tft_shadow.buf) return;
+  if ((x < 0) || (y < 0) || (x >= tft_shadow.width) || (y >= tft_shadow.height)) return;
+  tft_shadow.buf[x + y * tft_shadow.width] = shadowColor(color);
+  if (tft_shadow.defer) shadowMark(x, x, y);
+}
+
+/***************************************************************************************
+** Function name:           createShadow
+** Description:             allocate the shadow framebuffer, cleared to black
+***************************************************************************************/
+bool TFT_eeSPI::createShadow(void)
+{
+  deleteShadow();
+
+  int32_t w = width(), h = height();
+  int32_t tx = (w + TFT_SHADOW_TILE - 1) / TFT_SHADOW_TILE;
+  int32_t ty = (h + TFT_SHADOW_TILE - 1) / TFT_SHADOW_TILE;
+  tft_shadow.buf = (shadow_t*) calloc(w * h, sizeof(shadow_t));
+  tft_shadow.dirty = (uint8_t*) calloc((tx * ty + 7) >> 3, 1);
+  if (!tft_shadow.buf || !tft_shadow.dirty) {
+    deleteShadow();
+    return false;
+  }
+
+  tft_shadow.tilesX = tx;
+  tft_shadow.tilesY = ty;
+  tft_shadow.width = w;
+  tft_shadow.height = h;
+  shadowWindow(0, 0, w - 1, h - 1);
+  return true;
+}
+
+/***************************************************************************************
+** Function name:           deleteShadow
+** Description:             free the shadow framebuffer, reads go to the panel again
+***************************************************************************************/
+void TFT_eeSPI::deleteShadow(void)
+{
+  if (tft_shadow.buf) free(tft_shadow.buf);
+  if (tft_shadow.dirty) free(tft_shadow.dirty);
+  tft_shadow.buf = nullptr;
+  tft_shadow.dirty = nullptr;
+  tft_shadow.defer = false;
+}
+
+/***************************************************************************************
+** Function name:           loadShadow
+** Description:             read the panel into the shadow framebuffer
+***************************************************************************************/
+bool TFT_eeSPI::loadShadow(void)
+{
+  if (!tft_shadow.buf) return false;
+
+  // The rotation changed the screen size, the shadow is made again for it
+  if (!shadowFits()) {
+    bool defer = tft_shadow.defer;
+    if (!createShadow()) return false;
+    tft_shadow.defer = defer;
+  }
+
+  // readRect() reads the whole screen, not the user's viewport
+  int32_t  xDatum  = _xDatum,  yDatum  = _yDatum;
+  int32_t  xWidth  = _xWidth,  yHeight = _yHeight;
+  int32_t  vpX = _vpX, vpY = _vpY, vpW = _vpW, vpH = _vpH;
+  bool     vpDatum = _vpDatum, vpOoB = _vpOoB;
+  resetViewport();
+
+  // With no shadow readRect() reads the panel, one row at a time
+  shadow_t *buf = tft_shadow.buf;
+  int32_t   w = tft_shadow.width;
+  uint16_t  line[w];
+  tft_shadow.buf = nullptr;
+  for (int32_t y = 0; y < tft_shadow.height; y++) {
+    readRect(0, y, w, 1, line);
+    const uint8_t *p = (const uint8_t *)line;
+    for (int32_t x = 0; x < w; x++, p += 2) buf[x + y * w] = shadowColor565(p[0] << 8 | p[1]);
+  }
+  tft_shadow.buf = buf;
+
+  _xDatum  = xDatum;  _yDatum  = yDatum;
+  _xWidth  = xWidth;  _yHeight = yHeight;
+  _vpX = vpX;  _vpY = vpY;  _vpW = vpW;  _vpH = vpH;
+  _vpDatum = vpDatum;  _vpOoB = vpOoB;
+
+  // The panel shows it all
+  memset(tft_shadow.dirty, 0, (tft_shadow.tilesX * tft_shadow.tilesY + 7) >> 3);
+  return true;
+}
+
+/***************************************************************************************
+** Function name:           setShadowDefer
+** Description:             keep the drawing in the shadow until flushShadow()
+***************************************************************************************/
+void TFT_eeSPI::setShadowDefer(bool defer)
+{
+  if (!tft_shadow.buf) return;
+
+  if (!defer) flushShadow();
+  tft_shadow.defer = defer;
+}
+
+/***************************************************************************************
+** Function name:           flushShadow
+** Description:             send the dirty tiles of the shadow, merged in rectangles
+***************************************************************************************/
+void TFT_eeSPI::flushShadow(void)
+{
+  // Not sent in another rotation, loadShadow() first
+  if (!shadowFits()) return;
+
+  // Nothing drawn since the last flush
+  int32_t tx = tft_shadow.tilesX, ty = tft_shadow.tilesY;
+  int32_t n = (tx * ty + 7) >> 3, d = 0;
+  while (d < n && !tft_shadow.dirty[d]) d++;
+  if (d == n) return;
+
+  BUS_STATS_API(BUS_API_FLUSH);
+
+  // The pixels come from the shadow, it is not written again while they are sent
+  shadow_t *buf = tft_shadow.buf;
+  bool defer = tft_shadow.defer;
+  tft_shadow.buf = nullptr;
+  tft_shadow.defer = false;
+
+  begin_tft_write();
+  inTransaction = true;
+
+  // A line is converted while the one before is sent
+  uint32_t  lineMem[TFT_LINE_WORDS(tft_shadow.width)];
+  uint16_t* lineBuf = lineBuffers(lineMem, tft_shadow.width);
+
+  for (int32_t j = 0; j < ty; j++) {
+    int32_t i = 0;
+    while (i < tx) {
+      if (!shadowDirty(j * tx + i)) { i++; continue; }
+
+      // Run of dirty tiles in this row, taken down while the rows below are dirty under
+      // all of it
+      int32_t i1 = i + 1;
+      while (i1 < tx && shadowDirty(j * tx + i1)) i1++;
+      int32_t j1 = j + 1;
+      for (; j1 < ty; j1++) {
+        int32_t k = i;
+        while (k < i1 && shadowDirty(j1 * tx + k)) k++;
+        if (k < i1) break;
+      }
+      for (int32_t m = j; m < j1; m++) {
+        for (int32_t k = i; k < i1; k++) {
+          int32_t t = m * tx + k;
+          tft_shadow.dirty[t >> 3] &= ~(1 << (t & 7));
+        }
+      }
+
+      // The last tiles are cut at the screen edge
+      int32_t x = i * TFT_SHADOW_TILE, y = j * TFT_SHADOW_TILE;
+      int32_t w = i1 * TFT_SHADOW_TILE, h = j1 * TFT_SHADOW_TILE;
+      if (w > tft_shadow.width) w = tft_shadow.width;
+      if (h > tft_shadow.height) h = tft_shadow.height;
+      w -= x;
+      h -= y;
+
+      setWindow(x, y, x + w - 1, y + h - 1);
+      for (int32_t y1 = y; y1 < y + h; y1++) {
+        const shadow_t *p = buf + x + y1 * tft_shadow.width;
+        for (int32_t k = 0; k < w; k++) {
+          uint16_t c = shadowTo565(p[k]);
+#if defined(COLOR_565)
+          // Sent as they are in memory, high byte first
+          uint8_t *b = (uint8_t *)(lineBuf + k);
+          b[0] = c >> 8;
+          b[1] = c;
+#else
+          lineBuf[k] = c;
+#endif
+        }
+        lineBuf = pushLineBuffered(lineBuf, w);
+      }
+      i = i1;
+    }
+  }
+  pushPixelsWait();
+
+  inTransaction = lockTransaction;
+  end_tft_write();
+
+  tft_shadow.buf = buf;
+  tft_shadow.defer = defer;
+}
+
+#endif
+
+/***************************************************************************************
+** Function name:           readRect
+** Description:             read a rectangle of 565 pixels, from the shadow if there is one
+***************************************************************************************/
+void TFT_eeSPI::readRect(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *data)
+{
+  int32_t x0 = x + _xDatum, y0 = y + _yDatum, dw = w;
+  if (!clipAddrWindow(&x, &y, &w, &h)) return;
+  data += (x - x0) + (y - y0) * dw;
+
+  BUS_STATS_API(BUS_API_READPIXEL);
+#ifdef TFT_SHADOW
+  bool shadow = shadowFits();
+  if (!shadow)
+#endif
+  begin_tft_read();
+
+  for (int32_t j = 0; j < h; j++) {
+    uint8_t *p = (uint8_t *)(data + j * dw);
+    for (int32_t i = 0; i < w; i++) {
+      uint16_t c;
+#ifdef TFT_SHADOW
+      if (shadow) c = shadow565(x + i, y + j);
+      else
+#endif
+      {
+        BUS_STATS_READ();
+        rgb_t color = innerReadPixel(x + i, y + j);
+        c = ((color >> 8) & 0xF800) | ((color >> 5) & 0x07E0) | ((color >> 3) & 0x001F);
+      }
+      // High byte first, as pushRect() sends them
+      *p++ = c >> 8;
+      *p++ = c;
+    }
+  }
+}
+
+#if defined(TFT_BUS_STATS) || defined(TFT_WINDOW_CACHE) || defined(TFT_SHADOW)
+
+/***************************************************************************************
+** Function name:           drawPixel
+** Description:             count the window and the pixel, then draw it
+***************************************************************************************/
+void TFT_eeSPI::drawPixel(int32_t x, int32_t y, rgb_t color)
+{
+  BUS_STATS_API(BUS_API_DRAWPIXEL);
+#ifdef TFT_SHADOW
+  shadowPixel(x, y, color);
+  if (tft_shadow.defer) return;
+#endif
+  BUS_STATS_WINDOW();
+  BUS_STATS_PIXELS(1);
+  WINDOW_INVALIDATE();
+  SnakeStamp::drawPixel(x, y, color);
+}
+
+#endif
+
+#if defined(TFT_WINDOW_CACHE) || defined(TFT_AUTO_BATCH)
+
+/***************************************************************************************
+** Function name:           setRotation
+** Description:             close the batch and forget the cached window, then rotate
+***************************************************************************************/
+void TFT_eeSPI::setRotation(uint8_t r, uint8_t REV)
+{
+#ifdef TFT_AUTO_BATCH
+  endBatch();
+#endif
+  WINDOW_INVALIDATE();
+  SnakeStamp::setRotation(r, REV);
+}
+
+#endif
+
+#ifdef TFT_BUS_STATS
+
+bus_stats_t tft_busStats;
+uint8_t     tft_busApi = BUS_API_OTHER;
+
+/***************************************************************************************
+** Function name:           getBusStats
+** Description:             bus traffic counters since the last resetBusStats()
+***************************************************************************************/
+const bus_stats_t& TFT_eeSPI::getBusStats(void)
+{
+  return tft_busStats;
+}
+
+/***************************************************************************************
+** Function name:           resetBusStats
+** Description:             clear all bus traffic counters
+***************************************************************************************/
+void TFT_eeSPI::resetBusStats(void)
+{
+  memset(&tft_busStats, 0, sizeof(tft_busStats));
+}
+
+/***************************************************************************************
+** Function name:           getBusApiName
+** Description:             name of the public call a BUS_API_xxx index stands for
+***************************************************************************************/
+const char* TFT_eeSPI::getBusApiName(uint8_t api)
+{
+  static const char* const names[BUS_API_COUNT] = {
+    "other",
+    "drawPixel",
+    "readPixel",
+    "pushColor",
+    "fillRect",
+    "drawFastLine",
+    "drawLine",
+    "drawRect",
+    "fillRectGradient",
+    "drawCircle",
+    "drawTriangle",
+    "fillPolygon",
+    "drawAlphaPixel",
+    "drawSmoothArc",
+    "drawSmoothShape",
+    "drawWedgeLine",
+    "drawBitmap",
+    "pushImage",
+    "pushSprite",
+    "drawChar",
+    "drawGlyph",
+    "drawString",
+    "flush"
+  };
+  return api < BUS_API_COUNT ? names[api] : "";
+}
+
+#if defined(TFT_BUS_MODEL_PIO_SPI)
+  #ifndef TFT_PIO_SPI_WRITE_DIV
+    #define TFT_PIO_SPI_WRITE_DIV 2
+  #endif
+  #ifndef TFT_PIO_SPI_READ_DIV
+    #define TFT_PIO_SPI_READ_DIV  5
+  #endif
+#endif
+
+/***************************************************************************************
+** Function name:           getBusModel
+** Description:             byte times of the bus selected in the Setup header
+***************************************************************************************/
+const bus_model_t& TFT_eeSPI::getBusModel(void)
+{
+  static const bus_model_t model = {
+#if defined(TFT_BUS_MODEL_8BITP)
+    1.0e9f / (TFT_8BITP_WRITE_SPEED),
+    1.0e9f / (TFT_8BITP_READ_SPEED),
+#elif defined(TFT_BUS_MODEL_PIO_SPI)
+    8.0e9f * (TFT_PIO_SPI_WRITE_DIV) / (TFT_PIO_CLOCK),
+    8.0e9f * (TFT_PIO_SPI_READ_DIV) / (TFT_PIO_CLOCK),
+#else
+    8.0e9f / (TFT_SPI_WRITE_SPEED),
+    8.0e9f / (TFT_SPI_READ_SPEED),
+#endif
+#if defined(COLOR_565)
+    2
+#else
+    3
+#endif
+  };
+  return model;
+}
+
+/***************************************************************************************
+** Function name:           getBusTime
+** Description:             predict the time the counted traffic keeps the bus busy
+***************************************************************************************/
+void TFT_eeSPI::getBusTime(const bus_count_t& count, bus_time_t& time)
+{
+  const bus_model_t& m = getBusModel();
+
+  // A window is CASET + 4 bytes, RASET + 4 bytes and RAMWR
+  const float windowNs = 11 * m.writeByteNs;
+
+  // A read sets the window with RAMRD instead of RAMWR, then a dummy byte
+  // and the colour, always 3 bytes, are clocked in at the read speed
+  const float readNs = windowNs + 4 * m.readByteNs;
+
+  time.windowUs      = count.windows * windowNs / 1000;
+  time.pixelUs       = (float)count.pixels * m.pixelBytes * m.writeByteNs / 1000;
+  time.readUs        = count.reads * readNs / 1000;
+  time.transactionUs = count.transactions * (float)(TFT_BUS_TX_OVERHEAD_NS) / 1000;
+  time.totalUs       = time.windowUs + time.pixelUs + time.readUs + time.transactionUs;
+}
+
+#endif
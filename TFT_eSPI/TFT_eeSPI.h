@@ -67,6 +67,236 @@
 **                         Section 7: Diagnostic support
 ***************************************************************************************/
 
+// Bus traffic statistics, define TFT_BUS_STATS in the Setup header to enable.
+// When not defined all the counting macros below are empty and nothing is compiled in.
+#ifdef TFT_BUS_STATS
+
+// Public calls the traffic is attributed to
+enum {
+  BUS_API_OTHER = 0,   // Not attributed, e.g. setAddrWindow() + pushColor() from a sketch
+  BUS_API_DRAWPIXEL,
+  BUS_API_READPIXEL,
+  BUS_API_PUSHCOLOR,
+  BUS_API_FILLRECT,    // fillRect, fillSpans, fillRects
+  BUS_API_FASTLINE,    // drawFastHLine, drawFastVLine
+  BUS_API_DRAWLINE,
+  BUS_API_RECT,        // drawRect, drawRoundRect, fillRoundRect
+  BUS_API_GRADIENT,    // fillRectVGradient, fillRectHGradient, linear, radial and conic
+  BUS_API_CIRCLE,      // drawCircle, fillCircle, drawEllipse, fillEllipse
+  BUS_API_TRIANGLE,
+  BUS_API_POLYGON,
+  BUS_API_ALPHAPIXEL,
+  BUS_API_SMOOTHARC,   // drawSmoothArc, drawArc
+  BUS_API_SMOOTHSHAPE, // drawSmoothCircle, fillSmoothCircle, smooth round rects
+  BUS_API_WEDGELINE,   // drawSpot, drawWideLine, drawWedgeLine
+  BUS_API_BITMAP,
+  BUS_API_PUSHIMAGE,   // pushImage, pushRect, pushMaskedImage
+  BUS_API_PUSHSPRITE,
+  BUS_API_DRAWCHAR,
+  BUS_API_DRAWGLYPH,
+  BUS_API_DRAWSTRING,
+  BUS_API_FLUSH,       // Display list replay, flushShadow
+  BUS_API_COUNT
+};
+
+typedef struct {
+  uint32_t calls;        // Public calls made (outermost only)
+  uint32_t transactions; // begin_tft_write() that really started a bus transaction
+  uint32_t windows;      // Address windows set
+  uint32_t pixels;       // Pixels sent
+  uint32_t reads;        // Pixel read round-trips
+} bus_count_t;
+
+typedef struct {
+  bus_count_t total;
+  bus_count_t api[BUS_API_COUNT];
+} bus_stats_t;
+
+extern bus_stats_t tft_busStats;
+extern uint8_t     tft_busApi;
+
+// Attribute the bus traffic to the outermost public call, so fillCircle() is
+// not reported as drawFastHLine(). Sprite drawing counts calls, but has no traffic.
+struct bus_api_scope {
+  bool outer;
+  bus_api_scope(uint8_t api) : outer(tft_busApi == BUS_API_OTHER) {
+    if (outer) {
+      tft_busApi = api;
+      ++tft_busStats.api[api].calls;
+      ++tft_busStats.total.calls;
+    }
+  }
+  ~bus_api_scope() { if (outer) tft_busApi = BUS_API_OTHER; }
+};
+
+// Wire-time cost model, converts the counters to the time the panel bus is busy.
+// The bus is taken from the write protocol selected in the Setup header, on the host
+// (virtual panel) one of TFT_BUS_MODEL_SPI, TFT_BUS_MODEL_PIO_SPI, TFT_BUS_MODEL_8BITP
+// may be defined to predict another board with the same counters.
+#if !defined(TFT_BUS_MODEL_SPI) && !defined(TFT_BUS_MODEL_PIO_SPI) && !defined(TFT_BUS_MODEL_8BITP)
+  #if defined(TFT_PIO_SPI_WRITE)
+    #define TFT_BUS_MODEL_PIO_SPI
+  #elif defined(TFT_PIO_8BITP_WRITE) || defined(TFT_GPIO_8BITP_WRITE)
+    #define TFT_BUS_MODEL_8BITP
+  #else
+    #define TFT_BUS_MODEL_SPI
+  #endif
+#endif
+
+// PIO SPI clock is the system clock divided by TFT_PIO_SPI_WRITE_DIV / TFT_PIO_SPI_READ_DIV
+#ifndef TFT_PIO_CLOCK
+  #define TFT_PIO_CLOCK      125 * 1000 * 1000     // RP2040 default system clock
+#endif
+
+// 8-bit parallel has no clock in the Setup, these are write and read strobes per second
+#ifndef TFT_8BITP_WRITE_SPEED
+  #if defined(TFT_GPIO_8BITP_WRITE)
+    #define TFT_8BITP_WRITE_SPEED  8 * 1000 * 1000 // bit-banged by the CPU
+  #else
+    #define TFT_8BITP_WRITE_SPEED 15 * 1000 * 1000 // ILI9488 twc = 66 ns
+  #endif
+#endif
+#ifndef TFT_8BITP_READ_SPEED
+  #define TFT_8BITP_READ_SPEED   2 * 1000 * 1000   // ILI9488 trc = 450 ns
+#endif
+
+// Fixed cost of a transaction: chip select, clock switch, DMA/PIO restart
+#ifndef TFT_BUS_TX_OVERHEAD_NS
+  #define TFT_BUS_TX_OVERHEAD_NS   500
+#endif
+
+typedef struct {
+  float writeByteNs;     // One byte (8-bit parallel: one strobe) written
+  float readByteNs;      // One byte read
+  uint8_t pixelBytes;    // Bytes per pixel written, 2 for COLOR_565, 3 for 666
+} bus_model_t;
+
+typedef struct {
+  float windowUs;        // CASET, RASET and RAMWR with parameters, 11 bytes
+  float pixelUs;         // Pixel data
+  float readUs;          // Window, RAMRD, dummy byte and 3 colour bytes per read
+  float transactionUs;   // TFT_BUS_TX_OVERHEAD_NS per transaction
+  float totalUs;
+} bus_time_t;
+
+  #define BUS_STATS_COUNT(field, n) { tft_busStats.total.field += (n); tft_busStats.api[tft_busApi].field += (n); }
+  #define BUS_STATS_API(api)        bus_api_scope _bus_api_scope(api)
+  #define BUS_STATS_TRANSACTION()   BUS_STATS_COUNT(transactions, 1)
+  #define BUS_STATS_WINDOW()        BUS_STATS_COUNT(windows, 1)
+  #define BUS_STATS_PIXELS(n)       BUS_STATS_COUNT(pixels, n)
+  #define BUS_STATS_READ()          BUS_STATS_COUNT(reads, 1)
+#else
+  #define BUS_STATS_API(api)
+  #define BUS_STATS_TRANSACTION()
+  #define BUS_STATS_WINDOW()
+  #define BUS_STATS_PIXELS(n)
+  #define BUS_STATS_READ()
+#endif
+
+// Address window cache, define TFT_WINDOW_CACHE in the Setup header to enable.
+// The window set on the panel and the pixels written since are tracked, setWindow() is
+// skipped when the window asked for lies in the same columns of the one on the panel,
+// and the write pointer is already at its start. The panel keeps the window as asked,
+// so pixels written past its end wrap back to its start. A protocol defining
+// TFT_WRITE_ADDR_AXES sends only the columns or only the rows when the other axis
+// is on the panel already. The panel keeps its window while chip select is high, so
+// it lasts across transactions, only reads, drawPixel() of the base class,
+// setRotation() and init() clear it.
+#ifdef TFT_WINDOW_CACHE
+
+typedef struct {
+  int32_t  xs, ys, xe, ye; // Window set on the panel
+  uint32_t ptr;            // Pixels written since
+  bool     valid;
+} tft_window_t;
+
+extern tft_window_t tft_window;
+
+  #define WINDOW_PIXELS(n)          tft_window.ptr += (n)
+  #define WINDOW_INVALIDATE()       tft_window.valid = false
+#else
+  #define WINDOW_PIXELS(n)
+  #define WINDOW_INVALIDATE()
+#endif
+
+// Shadow framebuffer, define TFT_SHADOW in the Setup header to enable, then call
+// createShadow(). Every window and pixel sent to the panel is stored in a copy in RAM
+// too, so readPixel() and readRect() are answered without a bus read. This makes the
+// smooth graphics and fonts that read the background (bg_color WHITE) write-only.
+// TFT_SHADOW_DEPTH 16 keeps 565 pixels, 8 keeps 332 pixels in half the RAM, read back
+// with the low bits lost. The shadow is in the coordinates of the rotation it was
+// created in, drawing done by the inherited SCREEN class is not seen by it. Reads do
+// not use it once the screen size differs, loadShadow() makes it again for the new
+// rotation.
+// With setShadowDefer() the drawing only goes to the shadow, the TFT_SHADOW_TILE square
+// tiles it touches are marked and flushShadow() sends them, see below.
+#ifdef TFT_SHADOW
+  #ifndef TFT_SHADOW_DEPTH
+    #define TFT_SHADOW_DEPTH 16
+  #endif
+
+  #ifndef TFT_SHADOW_TILE
+    #define TFT_SHADOW_TILE 16
+  #endif
+
+  #if TFT_SHADOW_DEPTH == 8
+    typedef uint8_t  shadow_t;
+  #else
+    typedef uint16_t shadow_t;
+  #endif
+
+typedef struct {
+  shadow_t *buf;           // width x height pixels, nullptr until createShadow()
+  int32_t  width, height;
+  int32_t  xs, ys, xe, ye; // Window set on the panel
+  int32_t  x, y;           // Write pointer
+  uint8_t  *dirty;         // One bit per tile, tilesX bits a row of tiles
+  int32_t  tilesX, tilesY;
+  bool     defer;          // Nothing is sent, see setShadowDefer()
+} tft_shadow_t;
+
+extern tft_shadow_t tft_shadow;
+
+void shadowWindow(int32_t xs, int32_t ys, int32_t xe, int32_t ye);
+void shadowFill(rgb_t color, int32_t len);
+void shadowPixels(const uint16_t *data, int32_t len);
+void shadowPixel(int32_t x, int32_t y, rgb_t color);
+
+  #define SHADOW_WINDOW(xs, ys, xe, ye) shadowWindow(xs, ys, xe, ye)
+  #define SHADOW_FILL(color, n)         shadowFill(color, n)
+  #define SHADOW_PIXELS(data, n)        shadowPixels(data, n)
+  #define SHADOW_DEFERRED()             tft_shadow.defer
+  #define SHADOW_DEFER()                if (tft_shadow.defer) return
+#else
+  #define SHADOW_WINDOW(xs, ys, xe, ye)
+  #define SHADOW_FILL(color, n)
+  #define SHADOW_PIXELS(data, n)
+  #define SHADOW_DEFERRED()             false
+  #define SHADOW_DEFER()
+#endif
+
+// Automatic transaction batching, define TFT_AUTO_BATCH in the Setup header to enable.
+// The transaction a drawing call opens is left open for the calls that follow. It is
+// closed by endWrite(), the reads, setRotation(), endBatch(), or pollBatch() after
+// TFT_BATCH_IDLE_US without a drawing call. Only the drawing calls leave it open, so
+// endBatch() or endWrite() releases the bus before it is used for touch. Nothing closes
+// it while the sketch is idle, loop() must call pollBatch().
+#ifdef TFT_AUTO_BATCH
+  #ifndef TFT_BATCH_IDLE_US
+    #define TFT_BATCH_IDLE_US  2000
+  #endif
+#endif
+
+// Line buffers of lineBuffers() and pushLineBuffered(), two when pushPixelsAsync() sends
+// while the next line is filled, otherwise one. TFT_LINE_WORDS(len) is the size of the
+// word aligned memory for lines of len pixels.
+#if defined(COLOR_565) && defined(TFT_SEND_ASYNC)
+  #define TFT_LINE_BUFFERS 2
+#else
+  #define TFT_LINE_BUFFERS 1
+#endif
+#define TFT_LINE_WORDS(len) (TFT_LINE_BUFFERS * (((len) + 1) >> 1))
+
 /***************************************************************************************
 **                         Section 8: Class member and support functions
 ***************************************************************************************/
@@ -79,6 +309,7 @@ class TFT_eeSPI : public SnakeStamp {
   friend class TFT_Print;
   friend class TFT_eSPI;
   friend class TFT_eSprite; // Sprite class has access to protected members
+  friend class TFT_ePath;   // Path filler clips to the viewport and sends runs
 
  //--------------------------------------- public ------------------------------------//
  public:
@@ -127,6 +358,12 @@ class TFT_eeSPI : public SnakeStamp {
 
            // Write a set of pixels stored in memory, use setSwapBytes(true/false) function to correct endianess
   void     pushPixels(const uint16_t* data_in, int32_t len);
+           // As pushPixels(), but returns while the pixels are sent when the protocol can
+           // (TFT_SEND_ASYNC), data must not change until the next pushPixelsAsync()
+           // or pushPixelsWait() returns. Only the host virtual panel provides it so far,
+           // on the boards this is a blocking pushPixels()
+  void     pushPixelsAsync(const uint16_t* data_in, int32_t len);
+  void     pushPixelsWait(void);
 
            // Swap the byte order for pushImage() and pushPixels() - corrects endianness
   void     setSwapBytes(bool swap);
@@ -137,14 +374,83 @@ class TFT_eeSPI : public SnakeStamp {
   void     writeColor(rgb_t color, int32_t len); // Deprecated, use pushBlock()
   void     endWrite(void);                           // End SPI transaction
 
+#ifdef TFT_AUTO_BATCH
+           // Close the transaction left open by the drawing calls
+  void     endBatch(void);
+           // Close it if nothing has been drawn for the idle time, call it from loop()
+  bool     pollBatch(void);
+  void     setBatchIdle(uint32_t us) { batchIdle = us; }
+#endif
+
+#if defined(TFT_BUS_STATS) || defined(TFT_WINDOW_CACHE) || defined(TFT_SHADOW)
+  using    SnakeStamp::drawPixel;
+           // Counted here so the pixel and window it costs show in the bus statistics,
+           // the window it sets is not known to the window cache
+  void     drawPixel(int32_t x, int32_t y, rgb_t color);
+#endif
+
+#if defined(TFT_WINDOW_CACHE) || defined(TFT_AUTO_BATCH)
+  using    SnakeStamp::setRotation;
+           // The window cached is in the old axes, it is forgotten, and the open batch
+           // is closed before the panel is sent its new orientation
+  void     setRotation(uint8_t r, uint8_t REV) override;
+#endif
+
+           // Read w x h 565 pixels at x,y into data, in the byte order pushRect() takes
+           // back. Parts outside the viewport are not written.
+  virtual void readRect(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *data);
+
+#ifdef TFT_SHADOW
+           // Allocate the shadow for the screen in the current rotation, cleared to
+           // black, false if the RAM is not available. Create it before drawing.
+  bool     createShadow(void);
+  void     deleteShadow(void);
+           // Read the whole panel into the shadow, after setRotation() or a write the
+           // library did not make. It is allocated again if the screen size changed,
+           // false if that fails. The panel is read a row at a time with readRect().
+  bool     loadShadow(void);
+  bool     hasShadow(void) { return tft_shadow.buf != nullptr; }
+           // Deferred drawing: while on, the drawing calls only write the shadow and nothing
+           // is sent until flushShadow(), so the panel never shows a frame half drawn.
+           // The shadow must hold what the panel shows, e.g. fillScreen() or loadShadow()
+           // first. Turning it off flushes.
+  void     setShadowDefer(bool defer);
+  bool     getShadowDefer(void) { return tft_shadow.defer; }
+           // Send the tiles drawn since the last flush, the neighbouring ones merged
+           // into rectangles, one window each
+  void     flushShadow(void);
+#endif
+
+#ifdef TFT_BUS_STATS
+           // Bus traffic counters since the last reset, total and per public call
+  const bus_stats_t& getBusStats(void);
+  void     resetBusStats(void);
+           // Name of BUS_API_xxx index, e.g. "fillRect"
+  static const char* getBusApiName(uint8_t api);
+           // Bus model of the Setup header and the wire time it predicts for the counters
+  static const bus_model_t& getBusModel(void);
+  static void getBusTime(const bus_count_t& count, bus_time_t& time);
+#endif
+
  private:
            // New begin and end prototypes
            // begin/end a TFT write transaction
            // For SPI bus the transmit clock rate is set
   inline void begin_tft_write() __attribute__((always_inline));
   inline void end_tft_write()   __attribute__((always_inline));
+           // Before a read, the bus switches protocol, so a batch left open is closed
+  inline void begin_tft_read()  __attribute__((always_inline));
+
+#ifdef TFT_SHADOW
+           // The shadow is there and in the size of the screen, the rotation it was
+           // made for may have been changed since
+  bool     shadowFits(void) { return tft_shadow.buf && tft_shadow.width == width() && tft_shadow.height == height(); }
+#endif
 
   bool     locked, inTransaction, lockTransaction; // SPI transaction and mutex lock flags
+#ifdef TFT_AUTO_BATCH
+  uint32_t batchIdle, batchTime; // Idle time allowed and micros() of the last drawing call
+#endif
 
  //-------------------------------------- protected ----------------------------------//
  protected:
@@ -162,5 +468,15 @@ class TFT_eeSPI : public SnakeStamp {
 
   bool     _swapBytes; // Swap the byte order for TFT pushImage()
 
+           // Lines sent one after the other in a window: lineBuffers() takes the memory,
+           // uint32_t mem[TFT_LINE_WORDS(len)], and returns the line to fill first,
+           // pushLineBuffered() sends a line and returns the one to fill next.
+           // pushPixelsWait() after the last line, before the memory goes.
+  uint16_t* lineBuffers(uint32_t* mem, int32_t len);
+  uint16_t* pushLineBuffered(uint16_t* line, int32_t len);
+#if TFT_LINE_BUFFERS > 1
+  uint16_t* _lineAlt; // The line filled while the one before is sent
+#endif
+
 
 };
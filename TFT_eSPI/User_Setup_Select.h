@@ -10,3 +10,16 @@
 #define LOAD_GFXFF  // FreeFonts. Include access to the 48 Adafruit_GFX free fonts FF1 to FF48 and custom fonts
 
 #define SMOOTH_FONT
+
+//#define DISPLAY_LIST  // TFT_eSPI beginRecording()/flush(), deferred and coalesced fills
+
+//#define STRIP_RENDER  // TFT_eStrips, Sprite strips drawn on another core (STRIP_CORE1 on the RP2040)
+
+//#define SPRITE_DIRTY  // TFT_eSprite pushDirty(), the area of every Sprite write is tracked
+
+#define SMOOTH_PATH   // TFT_ePath, anti-aliased filled lines and Bezier curves
+
+//#define SMOOTH_FIXED  // Smooth arcs, wedge lines and spots in Q16.16 fixed point instead of float
+
+//#define TFT_AUTO_BATCH  // Keep the write transaction open between drawing calls, loop() must then call
+                          // tft.pollBatch() to release it when idle, and endBatch() before a touch read
@@ -0,0 +1,107 @@
+/*
+ Banded rendering checks on the host virtual panel
+
+ pushBanded() draws a scene taller than the Sprite a band at a time, the
+ panel then shows what drawing the scene into one Sprite of its full
+ height would have, with one window per band. Shapes cross the band edges.
+
+ Sprites take 565 colours, the panel is read back as rgb_t.
+ */
+
+#include <TFT_eSPI.h>
+#include "host_check.h"
+
+TFT_eSPI    tft = TFT_eSPI();
+TFT_eSprite spr = TFT_eSprite(&tft);
+
+#define SCENE_W 120
+#define SCENE_H 150  // Not a multiple of the band height
+#define BAND_H  32
+
+// Each shape crosses at least one band edge (rows 32, 64, 96 and 128)
+static void drawScene(TFT_eSprite *band, void *param)
+{
+  int32_t *calls = (int32_t *)param;
+  if (calls) (*calls)++;
+
+  band->fillRect(10, 20, 40, 30, color24to16(TFT_RED));
+  band->drawRect(60, 25, 50, 50, color24to16(TFT_WHITE));
+  band->fillCircle(60, 96, 20, color24to16(TFT_BLUE));
+  band->drawLine(0, 0, SCENE_W - 1, SCENE_H - 1, color24to16(TFT_GREEN));
+  band->fillTriangle(5, 120, 50, 140, 20, 160, color24to16(TFT_YELLOW));
+  band->drawFastVLine(115, 10, 200, color24to16(TFT_CYAN));
+  band->drawPixel(100, 127, color24to16(TFT_WHITE));
+  band->drawPixel(100, 128, color24to16(TFT_WHITE));
+}
+
+int main(int argc, char* argv[])
+{
+  tft.init();
+  tft.setRotation(0);
+  host_panel_fill(TFT_MAGENTA);
+
+  // Drawn into one Sprite of the scene height for the reference
+  CHECK(spr.createSprite(SCENE_W, SCENE_H) != nullptr);
+  spr.fillSprite(color24to16(TFT_BLACK));
+  drawScene(&spr, nullptr);
+  spr.pushSprite(30, 40);
+  rgb_t *ref = (rgb_t *)malloc(SCENE_W * SCENE_H * sizeof(rgb_t));
+  CHECK(ref != nullptr);
+  if (!ref) return host_check_result("TFT_Band_Test");
+  for (int32_t y = 0; y < SCENE_H; y++)
+    for (int32_t x = 0; x < SCENE_W; x++) ref[y * SCENE_W + x] = host_panel_readPixel(30 + x, 40 + y);
+  spr.deleteSprite();
+  host_panel_fill(TFT_MAGENTA);
+
+  // The same scene through a band, with a user viewport to come back unchanged
+  CHECK(spr.createSprite(SCENE_W, BAND_H) != nullptr);
+  spr.setViewport(5, 6, 50, 20);
+  int32_t calls = 0;
+  tft.resetBusStats();
+  CHECK(spr.pushBanded(30, 40, SCENE_H, drawScene, &calls));
+
+  int32_t bands = (SCENE_H + BAND_H - 1) / BAND_H;
+  CHECK(calls == bands);
+  CHECK(tft.getBusStats().total.windows == (uint32_t)bands);
+  CHECK(tft.getBusStats().total.pixels == SCENE_W * SCENE_H);
+
+  int32_t bad = 0;
+  for (int32_t y = 0; y < SCENE_H; y++)
+    for (int32_t x = 0; x < SCENE_W; x++)
+      if (host_panel_readPixel(30 + x, 40 + y) != ref[y * SCENE_W + x]) bad++;
+  CHECK(bad == 0);
+
+  // Nothing is drawn past the scene
+  CHECK(host_panel_readPixel(145, 40 + SCENE_H) == TFT_MAGENTA);
+  CHECK(host_panel_readPixel(29, 40) == TFT_MAGENTA);
+
+  CHECK(spr.getViewportX() == 5);
+  CHECK(spr.getViewportY() == 6);
+  CHECK(spr.getViewportWidth() == 50);
+  CHECK(spr.getViewportHeight() == 20);
+  CHECK(spr.getViewportDatum());
+
+  // The viewport is used again after the bands
+  spr.fillSprite(color24to16(TFT_BLACK));
+  spr.fillRect(0, 0, 200, 200, color24to16(TFT_RED));
+  spr.resetViewport();
+  spr.pushSprite(30, 200);
+  CHECK(host_panel_readPixel(34, 205) == TFT_BLACK);
+  CHECK(host_panel_readPixel(35, 206) == TFT_RED);
+  CHECK(host_panel_readPixel(84, 225) == TFT_RED);
+  CHECK(host_panel_readPixel(85, 225) == TFT_BLACK);
+  CHECK(host_panel_readPixel(84, 226) == TFT_BLACK);
+
+  // A band of rows drawn alone matches the same rows of the scene
+  spr.drawBand(64, BAND_H, drawScene);
+  spr.pushSprite(30, 40);
+  bad = 0;
+  for (int32_t y = 0; y < BAND_H; y++)
+    for (int32_t x = 0; x < SCENE_W; x++)
+      if (host_panel_readPixel(30 + x, 40 + y) != ref[(64 + y) * SCENE_W + x]) bad++;
+  CHECK(bad == 0);
+
+  spr.deleteSprite();
+  free(ref);
+  return host_check_result("TFT_Band_Test");
+}
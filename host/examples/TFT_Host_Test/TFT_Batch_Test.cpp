@@ -0,0 +1,72 @@
+/*
+ Transaction batching checks on the host virtual panel, built with TFT_AUTO_BATCH
+
+ Only the drawing calls leave the write transaction open, endWrite(),
+ endBatch(), setRotation() and the reads always close it.
+ */
+
+#include <TFT_eSPI.h>
+#include "host_check.h"
+
+TFT_eSPI tft = TFT_eSPI();
+
+int main(int argc, char* argv[])
+{
+  tft.init();
+  tft.setRotation(0);
+  tft.endBatch();
+  tft.resetBusStats();
+
+  // Drawing calls share one transaction
+  tft.fillRect(0, 0, 10, 10, TFT_RED);
+  tft.drawFastHLine(20, 20, 10, TFT_GREEN);
+  tft.fillRect(30, 30, 10, 10, TFT_BLUE);
+  CHECK(host_panel_writing());
+  CHECK(tft.getBusStats().total.transactions == 1);
+
+  // endBatch() closes it
+  tft.endBatch();
+  CHECK(!host_panel_writing());
+
+  // An explicit endWrite() closes it, the batch the drawing call left open too
+  tft.fillRect(0, 0, 10, 10, TFT_RED);
+  tft.startWrite();
+  tft.fillRect(0, 0, 10, 10, TFT_GREEN);
+  CHECK(host_panel_writing());
+  tft.endWrite();
+  CHECK(!host_panel_writing());
+  tft.fillRect(0, 0, 10, 10, TFT_BLUE);
+  tft.endWrite();
+  CHECK(!host_panel_writing());
+  CHECK(tft.getBusStats().total.transactions == 3);
+
+  // A read closes it before switching the protocol
+  tft.fillRect(50, 50, 10, 10, TFT_YELLOW);
+  CHECK(host_panel_writing());
+  CHECK(tft.readPixel(55, 55) == TFT_YELLOW);
+  CHECK(!host_panel_writing());
+
+  uint16_t rect[4];
+  tft.fillRect(60, 60, 2, 2, TFT_WHITE);
+  tft.readRect(60, 60, 2, 2, rect);
+  CHECK(!host_panel_writing());
+  CHECK(rect[0] == 0xFFFF && rect[3] == 0xFFFF);
+
+  // setRotation() closes it before the panel is rotated
+  tft.fillRect(0, 0, 10, 10, TFT_RED);
+  CHECK(host_panel_writing());
+  tft.setRotation(0);
+  CHECK(!host_panel_writing());
+
+  // pollBatch() leaves it open until idle, then closes it
+  tft.setBatchIdle(1000000);
+  tft.fillRect(0, 0, 10, 10, TFT_GREEN);
+  CHECK(!tft.pollBatch());
+  CHECK(host_panel_writing());
+  tft.setBatchIdle(0);
+  tft.fillRect(0, 0, 10, 10, TFT_RED);
+  CHECK(tft.pollBatch());
+  CHECK(!host_panel_writing());
+
+  return host_check_result("TFT_Batch_Test");
+}
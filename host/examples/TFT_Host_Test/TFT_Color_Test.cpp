@@ -0,0 +1,326 @@
+/*
+ Colour checks on the host virtual panel
+
+ Built twice, for a 565 and for a 666 panel (TFT_HOST_666), every
+ path must show the colour drawPixel() shows for the same 565 value.
+ */
+
+#include <TFT_eSPI.h>
+#include "host_check.h"
+#include <math.h>
+
+TFT_eSPI tft = TFT_eSPI();
+TFT_eSprite spr = TFT_eSprite(&tft);
+
+// pushPixels() data is 565 high byte first on 565 panels, native on 666 ones
+static uint16_t mem565(uint16_t c)
+{
+#if defined(COLOR_565)
+  return (c >> 8) | (c << 8);
+#else
+  return c;
+#endif
+}
+
+static const uint16_t samples[] = {
+  0x0000, 0xFFFF, 0xF800, 0x07E0, 0x001F, 0x1234, 0xABCD, 0x7BEF, 0x8410, 0xFD20
+};
+static const int nSamples = sizeof(samples) / sizeof(samples[0]);
+
+static void checkPushPixels(void)
+{
+  uint16_t line[nSamples];
+  for (int i = 0; i < nSamples; i++) line[i] = mem565(samples[i]);
+
+  tft.startWrite();
+  tft.setAddrWindow(0, 0, nSamples, 1);
+  tft.pushPixels(line, nSamples);
+  tft.endWrite();
+
+  for (int i = 0; i < nSamples; i++) {
+    tft.drawPixel(i, 1, rgb(samples[i]));
+    CHECK_NEAR(host_panel_readPixel(i, 0), host_panel_readPixel(i, 1));
+    CHECK_NEAR(host_panel_readPixel(i, 0), rgb(samples[i]));
+  }
+
+  // Longer than one staging buffer, in odd lengths that continue the window
+  uint16_t run[201];
+  for (int i = 0; i < 201; i++) run[i] = mem565(samples[i % nSamples] ^ (i << 5));
+  tft.startWrite();
+  tft.setAddrWindow(0, 2, 201, 1);
+  tft.pushPixels(run, 67);
+  tft.pushPixels(run + 67, 1);
+  tft.pushPixels(run + 68, 133);
+  tft.endWrite();
+  for (int i = 0; i < 201; i++) CHECK_NEAR(host_panel_readPixel(i, 2), rgb(mem565(run[i])));
+  CHECK(host_panel_readPixel(201, 2) == TFT_BLACK);
+}
+
+// 332 to 565 as TFT_eSPI expands 8bpp images
+static uint16_t color332(uint8_t c)
+{
+  static const uint8_t blue[] = {0, 11, 21, 31};
+  return (c & 0xE0) << 8 | (c & 0xC0) << 5 | (c & 0x1C) << 6 | (c & 0x1C) << 3 | blue[c & 0x03];
+}
+
+static void checkIndexedImages(void)
+{
+  // 8bpp
+  uint8_t img8[16];
+  for (int i = 0; i < 16; i++) img8[i] = i * 17;
+  tft.pushImage(0, 10, 16, 1, img8, true);
+  for (int i = 0; i < 16; i++) CHECK_NEAR(host_panel_readPixel(i, 10), rgb(color332(img8[i])));
+
+  // 4bpp through a palette, odd start exercises the split first pixel
+  uint16_t cmap[16];
+  for (int i = 0; i < 16; i++) cmap[i] = samples[i % nSamples] ^ (i << 4);
+  uint8_t img4[8];
+  for (int i = 0; i < 8; i++) img4[i] = (2 * i) << 4 | (2 * i + 1);
+  tft.pushImage(0, 12, 16, 1, img4, false, cmap);
+  for (int i = 0; i < 16; i++) CHECK_NEAR(host_panel_readPixel(i, 12), rgb(cmap[i]));
+  tft.setViewport(1, 13, 15, 1, false);
+  tft.pushImage(0, 13, 16, 1, img4, false, cmap);
+  tft.resetViewport();
+  for (int i = 1; i < 16; i++) CHECK_NEAR(host_panel_readPixel(i, 13), rgb(cmap[i]));
+
+  // 1bpp in the bitmap colours, white on black
+  uint8_t img1[2] = { 0xA5, 0x0F };
+  tft.pushImage(0, 14, 16, 1, img1, false);
+  for (int i = 0; i < 16; i++) {
+    bool set = img1[i >> 3] & (0x80 >> (i & 7));
+    CHECK_NEAR(host_panel_readPixel(i, 14), set ? TFT_WHITE : TFT_BLACK);
+  }
+}
+
+// Gradients start at color1 and end at color2, dithered or not
+static void checkGradients(void)
+{
+  for (int dither = 0; dither < 2; dither++) {
+    tft.setGradientDither(dither);
+
+    tft.fillRectHGradient(0, 20, 64, 8, TFT_RED, TFT_BLUE);
+    for (int j = 20; j < 28; j++) {
+      CHECK_NEAR(host_panel_readPixel(0, j), TFT_RED);
+      CHECK_NEAR(host_panel_readPixel(63, j), TFT_BLUE);
+    }
+
+    tft.fillRectVGradient(0, 30, 8, 64, TFT_GREEN, TFT_MAGENTA);
+    for (int i = 0; i < 8; i++) {
+      CHECK_NEAR(host_panel_readPixel(i, 30), TFT_GREEN);
+      CHECK_NEAR(host_panel_readPixel(i, 93), TFT_MAGENTA);
+    }
+  }
+  tft.setGradientDither(false);
+
+  // Through the 256 colour ramp
+  tft.fillRectLinearGradient(0, 100, 64, 8, TFT_RED, TFT_BLUE, 0);
+  CHECK_NEAR(host_panel_readPixel(0, 104), TFT_RED);
+  CHECK_NEAR(host_panel_readPixel(63, 104), TFT_BLUE);
+
+  // Corner to corner, the other two corners are half way
+  tft.fillRectLinearGradient(100, 100, 40, 40, TFT_RED, TFT_BLUE, 45);
+  CHECK_NEAR(host_panel_readPixel(100, 100), TFT_RED);
+  CHECK_NEAR(host_panel_readPixel(139, 139), TFT_BLUE);
+  CHECK_NEAR(host_panel_readPixel(139, 100), host_panel_readPixel(100, 139));
+  CHECK(host_near(host_panel_readPixel(139, 100), tft.alphaBlend(128, TFT_BLUE, TFT_RED), 12));
+}
+
+// Arc of radius 30, 20 inside, from 6 o'clock clockwise to 12 o'clock, centred at
+// cx,cy: red at the start, blue at the end, nothing outside the ring, its one pixel
+// fringe or the sweep
+static void checkArcRing(int32_t cx, int32_t cy)
+{
+  for (int32_t dy = -34; dy <= 34; dy++) {
+    for (int32_t dx = -34; dx <= 34; dx++) {
+      int32_t d2 = dx * dx + dy * dy;
+      float a = atan2f(-dx, dy) * 180.0f / M_PI; // Clockwise from 6 o'clock
+      if (a < 0) a += 360.0f;
+      rgb_t c = host_panel_readPixel(cx + dx, cy + dy);
+      if (d2 >= 31 * 31 || d2 <= 19 * 19 || (a > 182.0f && a < 358.0f)) CHECK(c == TFT_BLACK);
+      else if (d2 <= 30 * 30 && d2 >= 20 * 20 && a > 2.0f && a < 178.0f) CHECK(c != TFT_BLACK);
+    }
+  }
+  CHECK_NEAR(host_panel_readPixel(cx - 1, cy + 25), TFT_RED);
+  CHECK_NEAR(host_panel_readPixel(cx - 1, cy - 25), TFT_BLUE);
+
+  // Fringe pixels are blended with the black background by how far they are
+  // outside: 30.41 out, 0.59 covered, and 19.65 in, 0.65 covered
+  rgb_t outer = host_panel_readPixel(cx - 30, cy + 5);
+  rgb_t inner = host_panel_readPixel(cx - 19, cy + 5);
+  CHECK(host_near(outer, tft.alphaBlend(150, host_panel_readPixel(cx - 29, cy + 5), TFT_BLACK), 12));
+  CHECK(host_near(inner, tft.alphaBlend(165, host_panel_readPixel(cx - 20, cy + 5), TFT_BLACK), 12));
+  CHECK(outer != TFT_BLACK && inner != TFT_BLACK);
+}
+
+static void checkArcGradient(void)
+{
+  // The background behind the fringe is read back
+  tft.fillScreen(TFT_BLACK);
+  tft.resetBusStats();
+  tft.fillArcGradient(60, 160, 30, 20, 0, 180, TFT_RED, TFT_BLUE);
+  CHECK(tft.getBusStats().total.reads > 0);
+  checkArcRing(60, 160);
+
+  // Or given
+  tft.fillScreen(TFT_BLACK);
+  tft.resetBusStats();
+  tft.fillArcGradient(60, 160, 30, 20, 0, 180, TFT_RED, TFT_BLUE, TFT_BLACK);
+  CHECK(tft.getBusStats().total.reads == 0);
+  checkArcRing(60, 160);
+
+#if defined(COLOR_565)
+  // The same arc drawn in a Sprite, partly outside it. 16 bpp Sprites hold 565 in
+  // wire order, they are only pushed as they are to 565 panels.
+  spr.setColorDepth(16);
+  spr.createSprite(50, 70);
+  spr.fillSprite(TFT_BLACK);
+  spr.fillArcGradient(35, 35, 30, 20, 0, 180, TFT_RED, TFT_BLUE);
+  spr.pushSprite(145, 125);
+  spr.deleteSprite();
+  checkArcRing(180, 160);
+#endif
+}
+
+// Anti-aliased edges are blended runs, see pushSpan()
+static void checkWedgeLine(void)
+{
+  tft.fillScreen(TFT_BLACK);
+  tft.drawWedgeLine(20, 200, 100, 200, 4, 4, TFT_CYAN, TFT_BLACK);
+  for (int x = 30; x <= 90; x += 10) {
+    CHECK_NEAR(host_panel_readPixel(x, 200), TFT_CYAN);
+    CHECK(host_panel_readPixel(x, 194) == TFT_BLACK);
+    CHECK(host_panel_readPixel(x, 206) == TFT_BLACK);
+  }
+  // The fringe is between the two colours, the same on both sides
+  rgb_t top = host_panel_readPixel(60, 196), bottom = host_panel_readPixel(60, 204);
+  CHECK(top != TFT_BLACK && top != TFT_CYAN);
+  CHECK_NEAR(top, bottom);
+  CHECK((top & 0xFF0000) == 0);
+
+  // In a Sprite the fringe is blended into it and nothing is sent to the panel
+  tft.fillScreen(TFT_BLACK);
+  spr.createSprite(60, 40);
+  spr.fillSprite(TFT_BLACK);
+  spr.drawWedgeLine(10, 20, 50, 20, 4, 4, TFT_WHITE, TFT_BLACK);
+  int32_t sent = 0;
+  for (int32_t y = 0; y < 40; y++)
+    for (int32_t x = 0; x < 60; x++) sent += host_panel_readPixel(x, y) != TFT_BLACK;
+  CHECK(sent == 0);
+  uint16_t fringe = spr.readPixel(30, 16);
+  CHECK(fringe != 0 && fringe != 0xFFFF);
+  CHECK(spr.readPixel(30, 16) == spr.readPixel(30, 24));
+  spr.deleteSprite();
+}
+
+// A smooth font of one 16 x 20 anti-aliased ring, '0', built in RAM
+#define GLYPH_W 16
+#define GLYPH_H 20
+
+static uint8_t vlw[24 + 28 + GLYPH_W * GLYPH_H];
+static const uint8_t *glyph = vlw + 24 + 28;
+
+static uint8_t* putInt32(uint8_t* p, int32_t v)
+{
+  p[0] = v >> 24; p[1] = v >> 16; p[2] = v >> 8; p[3] = v;
+  return p + 4;
+}
+
+static void makeVlw(void)
+{
+  uint8_t* p = vlw;
+  const int32_t head[] = { 1, 11, GLYPH_H, 0, GLYPH_H, 4,                  // Font
+                           '0', GLYPH_H, GLYPH_W, GLYPH_W + 2, GLYPH_H, 1, 0 }; // Glyph
+  for (int32_t v : head) p = putInt32(p, v);
+  for (int32_t y = 0; y < GLYPH_H; y++) {
+    for (int32_t x = 0; x < GLYPH_W; x++) {
+      float dx = x - GLYPH_W / 2 + 0.5f, dy = y - GLYPH_H / 2 + 0.5f;
+      float d = fabsf(sqrtf(dx * dx + dy * dy) - 5.5f) - 1.0f;
+      *p++ = d <= 0 ? 255 : d >= 1 ? 0 : (uint8_t)(255 * (1 - d));
+    }
+  }
+}
+
+// Pixels of the glyph drawn at x,y blended over bg, tol for the 565 rounding
+static int32_t glyphErrors(int32_t x, int32_t y, rgb_t fg, const rgb_t *bg, int32_t tol)
+{
+  int32_t bad = 0;
+  for (int32_t j = 0; j < GLYPH_H; j++) {
+    for (int32_t i = 0; i < GLYPH_W; i++) {
+      uint8_t a = glyph[i + j * GLYPH_W];
+      rgb_t b = bg[i + j * GLYPH_W];
+      rgb_t want = a ? tft.alphaBlend(a, fg, b) : b;
+      if (!host_near(host_panel_readPixel(x + i, y + j), want, tol)) bad++;
+    }
+  }
+  return bad;
+}
+
+// Smooth font rows are blended in runs, one window each, see glyphSpan()
+static void checkGlyph(void)
+{
+  makeVlw();
+  rgb_t bg[GLYPH_W * GLYPH_H];
+
+  tft.fillScreen(TFT_BLUE);
+  tft.loadFont(vlw);
+  tft.setTextColor(TFT_YELLOW, TFT_BLUE);
+  tft.setCursor(40, 100);
+  tft.resetBusStats();
+  tft.drawGlyph('0');
+  int32_t gx = 40 + tft.gdX[0], gy = 100 + tft.gFont.maxAscent - tft.gdY[0];
+
+  for (int32_t i = 0; i < GLYPH_W * GLYPH_H; i++) bg[i] = TFT_BLUE;
+  CHECK(glyphErrors(gx, gy, TFT_YELLOW, bg, 12) == 0);
+
+  int32_t runs = 0;
+  for (int32_t j = 0; j < GLYPH_H; j++) {
+    for (int32_t i = 0; i < GLYPH_W; i++) {
+      if (glyph[i + j * GLYPH_W] && (i == 0 || !glyph[i - 1 + j * GLYPH_W])) runs++;
+    }
+  }
+  CHECK(tft.getBusStats().total.windows == (uint32_t)runs);
+  tft.unloadFont();
+
+#if defined(COLOR_565)
+  // A 16 bpp Sprite blends the runs in 565, over the text background
+  spr.setColorDepth(16);
+  spr.createSprite(40, 40);
+  spr.loadFont(vlw);
+  spr.fillSprite(color24to16(TFT_BLUE));
+  spr.setTextColor(color24to16(TFT_YELLOW), color24to16(TFT_BLUE));
+  spr.setCursor(10, 5);
+  spr.drawGlyph('0');
+  gx = 10 + spr.gdX[0];
+  gy = 5 + spr.gFont.maxAscent - spr.gdY[0];
+  spr.pushSprite(100, 100);
+  CHECK(glyphErrors(100 + gx, 100 + gy, TFT_YELLOW, bg, 16) == 0);
+
+  // Or over what is in the Sprite when both colours are the same
+  spr.fillSprite(color24to16(TFT_BLUE));
+  spr.fillRect(0, 0, 40, gy + GLYPH_H / 2, color24to16(TFT_RED));
+  spr.setTextColor(color24to16(TFT_YELLOW), color24to16(TFT_YELLOW));
+  spr.setCursor(10, 5);
+  spr.drawGlyph('0');
+  spr.pushSprite(100, 100);
+  for (int32_t i = 0; i < GLYPH_W * GLYPH_H; i++) bg[i] = i < GLYPH_W * GLYPH_H / 2 ? TFT_RED : TFT_BLUE;
+  CHECK(glyphErrors(100 + gx, 100 + gy, TFT_YELLOW, bg, 16) == 0);
+  spr.unloadFont();
+  spr.deleteSprite();
+#endif
+}
+
+int main(int argc, char* argv[])
+{
+  tft.init();
+  tft.setRotation(0);
+  tft.fillScreen(TFT_BLACK);
+
+  checkPushPixels();
+  checkIndexedImages();
+  checkGradients();
+  checkArcGradient();
+  checkWedgeLine();
+  checkGlyph();
+
+  return host_check_result("TFT_Color_Test");
+}
@@ -0,0 +1,86 @@
+/*
+ Display list checks on the host virtual panel, built with DISPLAY_LIST
+
+ Recorded fills reach the panel only at flush(), the panel then shows what
+ drawing them directly would have, in fewer windows. Fills painted over
+ are dropped and neighbours of one colour go in one window.
+ */
+
+#include <TFT_eSPI.h>
+#include "host_check.h"
+
+TFT_eSPI tft = TFT_eSPI();
+
+// Overdraw, neighbours to merge and overlaps that must keep their order
+static void drawScene(void)
+{
+  tft.fillScreen(TFT_BLACK);
+  tft.fillRect(10, 10, 50, 50, TFT_RED);      // Painted over by the next one
+  tft.fillRect(10, 10, 50, 50, TFT_BLUE);
+  for (int32_t y = 100; y < 110; y++) tft.drawFastHLine(20, y, 30, TFT_GREEN);
+  tft.fillRect(100, 10, 20, 20, TFT_RED);
+  tft.fillRect(110, 20, 20, 20, TFT_YELLOW);  // Over part of the red
+  tft.fillRect(100, 30, 20, 20, TFT_RED);     // Not merged over the yellow
+  tft.drawPixel(200, 300, TFT_WHITE);
+  tft.drawFastVLine(-5, 200, 400, TFT_CYAN);  // Off screen
+  tft.drawFastVLine(239, 200, 400, TFT_CYAN); // Clipped
+}
+
+int main(int argc, char* argv[])
+{
+  tft.init();
+  tft.setRotation(0);
+  int32_t size = tft.width() * tft.height();
+
+  // Drawn directly for the reference
+  drawScene();
+  rgb_t *ref = (rgb_t *)malloc(size * sizeof(rgb_t));
+  CHECK(ref != nullptr);
+  if (!ref) return host_check_result("TFT_Display_List_Test");
+  memcpy(ref, host_panel_buffer(), size * sizeof(rgb_t));
+  host_panel_fill(TFT_MAGENTA);
+
+  // Nothing is sent while recording
+  CHECK(tft.beginRecording(64));
+  CHECK(tft.isRecording());
+  tft.resetBusStats();
+  drawScene();
+  CHECK(tft.getBusStats().total.pixels == 0);
+  CHECK(tft.getBusStats().total.windows == 0);
+  CHECK(host_panel_readPixel(0, 0) == TFT_MAGENTA);
+
+  // Screen, blue, green, two red, yellow, white and cyan, in one transaction
+  tft.flush();
+  const bus_count_t& c = tft.getBusStats().total;
+  CHECK(c.windows == 8);
+  CHECK(c.transactions == 1);
+  CHECK(c.pixels == (uint32_t)size + 50 * 50 + 30 * 10 + 3 * 20 * 20 + 1 + 120);
+
+  int32_t bad = 0;
+  for (int32_t i = 0; i < size; i++) if (host_panel_buffer()[i] != ref[i]) bad++;
+  CHECK(bad == 0);
+  CHECK(host_panel_readPixel(115, 25) == TFT_YELLOW);
+  CHECK(host_panel_readPixel(105, 35) == TFT_RED);
+
+  // Still recording, a read sends what was recorded first
+  tft.fillRect(0, 0, 4, 4, TFT_BLUE);
+  CHECK(host_panel_readPixel(0, 0) == TFT_BLACK);
+  CHECK(tft.readPixel(0, 0) == TFT_BLUE);
+
+  // A list longer than its size is sent as it fills
+  tft.resetBusStats();
+  for (int32_t i = 0; i < 100; i++) tft.drawPixel(i * 2, 320 - 1, TFT_WHITE);
+  CHECK(tft.getBusStats().total.windows == 64);
+  tft.endRecording();
+  CHECK(!tft.isRecording());
+  CHECK(tft.getBusStats().total.windows == 100);
+  CHECK(host_panel_readPixel(198, 319) == TFT_WHITE);
+  CHECK(host_panel_readPixel(199, 319) == TFT_BLACK);
+
+  // Drawing goes to the panel again
+  tft.fillRect(0, 0, 4, 4, TFT_GREEN);
+  CHECK(host_panel_readPixel(3, 3) == TFT_GREEN);
+
+  free(ref);
+  return host_check_result("TFT_Display_List_Test");
+}
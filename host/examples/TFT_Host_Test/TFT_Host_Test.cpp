@@ -0,0 +1,53 @@
+/*
+ Exercise the library on the host virtual panel
+
+ Draws primitives, text and a sprite, then saves the panel
+ as TFT_Host_Test.ppm, or to the path given as the first argument.
+ */
+
+#include <TFT_eSPI.h>
+#include <TFT_API.h>
+#include <stdio.h>
+
+TFT_eSPI tft = TFT_eSPI();
+TFT_eSprite spr = TFT_eSprite(&tft);
+
+int main(int argc, char* argv[])
+{
+  const char* path = argc > 1 ? argv[1] : "TFT_Host_Test.ppm";
+
+  tft.init();
+  tft.setRotation(0);
+  tft.fillScreen(TFT_BLACK);
+
+  tft.fillRect(10, 10, 100, 50, TFT_RED);
+  tft.drawRect(8, 8, 104, 54, TFT_WHITE);
+  tft.drawLine(0, 0, 239, 319, TFT_GREEN);
+  tft.fillCircle(170, 60, 40, TFT_BLUE);
+  tft.drawSmoothArc(120, 160, 60, 50, 30, 330, TFT_YELLOW, TFT_BLACK, true);
+  tft.drawWedgeLine(20, 300, 220, 250, 2, 8, TFT_CYAN, TFT_BLACK);
+  tft.fillRectHGradient(10, 230, 220, 20, TFT_MAGENTA, TFT_BLUE);
+
+  tft.setTextColor(TFT_WHITE, TFT_BLACK);
+  tft.drawString("TFT_eSPI host", 10, 70, 2);
+  tft.drawString("0123", 10, 90, 4);
+
+  spr.createSprite(60, 40);
+  spr.fillSprite(TFT_ORANGE);
+  spr.drawString("spr", 5, 5, 2);
+  spr.pushSprite(170, 120);
+  spr.deleteSprite();
+
+  // the virtual panel must now hold what was drawn
+  if (tft.readPixel(20, 20) != TFT_RED || host_panel_readPixel(20, 20) != TFT_RED) {
+    printf("readPixel mismatch: %06x\n", (unsigned)tft.readPixel(20, 20));
+    return 1;
+  }
+
+  if (!host_panel_savePPM(path)) {
+    printf("cannot write %s\n", path);
+    return 1;
+  }
+  printf("%s written\n", path);
+  return 0;
+}
@@ -0,0 +1,156 @@
+/*
+ Shadow framebuffer checks on the host virtual panel, built with TFT_SHADOW
+
+ Reads are answered from the shadow without a bus read while it is the
+ size of the screen. After a rotation they go to the panel until
+ loadShadow() makes the shadow again for the new size.
+
+ Deferred drawing only reaches the panel at flushShadow(), in one window
+ for each rectangle of neighbouring dirty tiles.
+ */
+
+#include <TFT_eSPI.h>
+#include "host_check.h"
+
+TFT_eSPI tft = TFT_eSPI();
+
+static void checkReadBack(void)
+{
+  tft.setRotation(0);
+  CHECK(tft.createShadow());
+  tft.fillScreen(TFT_BLACK);
+  tft.fillRect(10, 20, 30, 40, TFT_RED);
+  tft.drawPixel(5, 6, TFT_GREEN);
+
+  // The shadow holds what was sent, no bus read is made
+  tft.resetBusStats();
+  CHECK(tft.readPixel(10, 20) == host_panel_readPixel(10, 20));
+  CHECK(tft.readPixel(39, 59) == TFT_RED);
+  CHECK(tft.readPixel(40, 59) == TFT_BLACK);
+  CHECK(tft.readPixel(5, 6) == TFT_GREEN);
+
+  uint16_t rect[4 * 3];
+  tft.readRect(38, 58, 4, 3, rect);
+  const uint8_t *p = (const uint8_t *)rect;
+  CHECK((p[0] << 8 | p[1]) == 0xF800);   // 38,58
+  CHECK((p[4] << 8 | p[5]) == 0x0000);   // 40,58
+  CHECK((p[16] << 8 | p[17]) == 0x0000); // 38,60
+  CHECK(tft.getBusStats().total.reads == 0);
+
+  // A write the library did not make is only seen after loadShadow()
+  host_panel_fill(TFT_BLUE);
+  CHECK(tft.readPixel(100, 100) == TFT_BLACK);
+  CHECK(tft.loadShadow());
+  CHECK(tft.readPixel(100, 100) == TFT_BLUE);
+  CHECK(tft.readPixel(10, 20) == TFT_BLUE);
+}
+
+static void checkRotation(void)
+{
+  // In another rotation the shadow of 240 x 320 no longer fits, the panel is read
+  tft.setRotation(1);
+  tft.resetViewport();   // The base class setRotation() does not
+  int32_t w = tft.width(), h = tft.height();
+  host_panel_fill(TFT_YELLOW);
+  host_panel_buffer()[(h - 1) * w + w - 1] = TFT_CYAN;
+
+  tft.resetBusStats();
+  CHECK(tft.readPixel(w - 1, h - 1) == TFT_CYAN);
+  CHECK(tft.readPixel(w - 1, 0) == TFT_YELLOW);
+  CHECK(tft.getBusStats().total.reads == 2);
+
+  // Made again for 320 x 240 and read from the panel
+  CHECK(tft.loadShadow());
+  host_panel_fill(TFT_BLACK);
+  tft.resetBusStats();
+  CHECK(tft.readPixel(w - 1, h - 1) == TFT_CYAN);
+  CHECK(tft.readPixel(w - 2, h - 1) == TFT_YELLOW);
+  CHECK(tft.getBusStats().total.reads == 0);
+
+  // Drawing in the new rotation is kept to the last column
+  tft.fillRect(w - 8, h - 8, 8, 8, TFT_MAGENTA);
+  CHECK(tft.readPixel(w - 1, h - 1) == TFT_MAGENTA);
+  CHECK(host_panel_readPixel(w - 1, h - 1) == TFT_MAGENTA);
+
+  // A viewport is kept by loadShadow()
+  tft.setViewport(50, 60, 20, 10);
+  CHECK(tft.loadShadow());
+  CHECK(tft.getViewportX() == 50 && tft.getViewportWidth() == 20);
+  CHECK(tft.readPixel(0, 0) == TFT_BLACK);
+  tft.resetViewport();
+
+  tft.deleteShadow();
+  CHECK(!tft.hasShadow());
+  CHECK(!tft.loadShadow());
+}
+
+static void checkDefer(void)
+{
+  tft.setRotation(0);
+  tft.resetViewport();
+  CHECK(tft.createShadow());
+  tft.fillScreen(TFT_BLACK);
+
+  // Nothing is sent while deferred
+  tft.setShadowDefer(true);
+  CHECK(tft.getShadowDefer());
+  tft.resetBusStats();
+  tft.fillRect(20, 20, 40, 30, TFT_RED);   // Tiles 1 to 3 across, 1 to 3 down
+  tft.drawPixel(200, 300, TFT_GREEN);      // Tile 12, 18
+  tft.drawString("Defer", 100, 150, 2);    // Tiles 6 to 8, 9 and 10
+  CHECK(tft.getBusStats().total.pixels == 0);
+  CHECK(tft.getBusStats().total.windows == 0);
+  CHECK(host_panel_readPixel(20, 20) == TFT_BLACK);
+  CHECK(host_panel_readPixel(200, 300) == TFT_BLACK);
+
+  // Reads come from the shadow
+  CHECK(tft.readPixel(20, 20) == TFT_RED);
+
+  // The dirty tiles are sent, the panel then shows what the shadow holds
+  tft.resetBusStats();
+  tft.flushShadow();
+  const bus_count_t& c = tft.getBusStats().total;
+  CHECK(c.windows == 3);
+  CHECK(c.pixels == 48 * 48 + 16 * 16 + 48 * 32);
+  CHECK(c.reads == 0);
+
+  int32_t bad = 0;
+  for (int32_t y = 0; y < tft.height(); y++) {
+    for (int32_t x = 0; x < tft.width(); x++) {
+      if (host_panel_readPixel(x, y) != tft.readPixel(x, y)) bad++;
+    }
+  }
+  CHECK(bad == 0);
+  CHECK(host_panel_readPixel(59, 49) == TFT_RED);
+  CHECK(host_panel_readPixel(60, 49) == TFT_BLACK);
+  CHECK(host_panel_readPixel(200, 300) == TFT_GREEN);
+
+  // Nothing left to send
+  tft.resetBusStats();
+  tft.flushShadow();
+  CHECK(tft.getBusStats().total.pixels == 0);
+
+  // Turning it off flushes
+  tft.fillRect(0, 0, 5, 5, TFT_BLUE);
+  CHECK(host_panel_readPixel(0, 0) == TFT_BLACK);
+  tft.setShadowDefer(false);
+  CHECK(!tft.getShadowDefer());
+  CHECK(host_panel_readPixel(4, 4) == TFT_BLUE);
+
+  // And drawing goes to the panel again
+  tft.drawPixel(7, 7, TFT_WHITE);
+  CHECK(host_panel_readPixel(7, 7) == TFT_WHITE);
+
+  tft.deleteShadow();
+}
+
+int main(int argc, char* argv[])
+{
+  tft.init();
+
+  checkReadBack();
+  checkRotation();
+  checkDefer();
+
+  return host_check_result("TFT_Shadow_Test");
+}
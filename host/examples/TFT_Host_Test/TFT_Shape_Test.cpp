@@ -0,0 +1,273 @@
+/*
+ Shape checks on the host virtual panel
+
+ fillPolygon() against an even-odd reference, including a polygon larger
+ than the stack edge table and edges too steep for a 32 bit slope.
+
+ drawLine() clipped to random viewports against the unclipped Bresenham
+ line, on the screen and in a Sprite.
+
+ TFT_ePath coverage, clipping to the viewport and a path that ran out of
+ edge memory.
+ */
+
+#include <TFT_eSPI.h>
+#include "host_check.h"
+#include <math.h>
+
+TFT_eSPI tft = TFT_eSPI();
+TFT_eSprite spr = TFT_eSprite(&tft);
+
+// Pixels further than 2 from the outline must be filled by the even-odd rule
+static void checkPolygon(const poly_point_t *p, int n)
+{
+  tft.fillScreen(TFT_BLACK);
+  CHECK(tft.fillPolygon(p, n, TFT_WHITE));
+
+  int32_t w = tft.width(), h = tft.height(), bad = 0;
+  for (int32_t y = 0; y < h; y++) {
+    double xc[256];
+    int nc = 0;
+    for (int i = 0; i < n && nc < 256; i++) {
+      const poly_point_t *a = &p[i], *b = &p[(i + 1) % n];
+      if (a->y == b->y) continue;
+      if (a->y > b->y) { const poly_point_t *t = a; a = b; b = t; }
+      if (y < a->y || y >= b->y) continue;
+      xc[nc++] = a->x + (double)(b->x - a->x) * (y - a->y) / (b->y - a->y);
+    }
+    for (int32_t x = 0; x < w; x++) {
+      int cross = 0;
+      bool near = false;
+      for (int i = 0; i < nc; i++) {
+        if (fabs(xc[i] - x) < 2.0) near = true;
+        if (xc[i] <= x) cross++;
+      }
+      if (near) continue;
+      bool inside = cross & 1;
+      if ((host_panel_readPixel(x, y) == TFT_WHITE) != inside) bad++;
+    }
+  }
+  CHECK(bad == 0);
+}
+
+static void checkPolygons(void)
+{
+  // The corners of a rectangle fill what fillRect() fills
+  poly_point_t rect[] = { {10, 10}, {50, 10}, {50, 30}, {10, 30} };
+  tft.fillScreen(TFT_BLACK);
+  tft.fillPolygon(rect, 4, TFT_WHITE);
+  CHECK(host_panel_readPixel(10, 10) == TFT_WHITE);
+  CHECK(host_panel_readPixel(49, 29) == TFT_WHITE);
+  CHECK(host_panel_readPixel(50, 29) == TFT_BLACK);
+  CHECK(host_panel_readPixel(49, 30) == TFT_BLACK);
+
+  // Self crossing star
+  poly_point_t star[5];
+  for (int i = 0; i < 5; i++) {
+    float a = i * 4 * M_PI / 5;
+    star[i].x = 120 + 100 * sinf(a);
+    star[i].y = 160 - 100 * cosf(a);
+  }
+  checkPolygon(star, 5);
+
+  // More vertices than the stack edge table holds
+  poly_point_t gear[100];
+  for (int i = 0; i < 100; i++) {
+    float a = i * 2 * M_PI / 100, r = (i & 1) ? 110 : 90;
+    gear[i].x = 120 + r * sinf(a);
+    gear[i].y = 160 - r * cosf(a);
+  }
+  checkPolygon(gear, 100);
+
+  // Edges starting far above the screen, x is found at the first row shown
+  poly_point_t tall[] = { {-32000, -1000}, {32000, 300}, {-32000, 300} };
+  checkPolygon(tall, 3);
+
+  // A nearly horizontal edge, 32000 pixels a row, crossing row 101 at x = 120
+  poly_point_t flat[] = { {-31880, 100}, {32120, 102}, {32120, 100} };
+  checkPolygon(flat, 3);
+}
+
+// The pixels of the unclipped Bresenham loop of drawLine(), in a w x h map
+static void referenceLine(uint8_t *map, int32_t w, int32_t h,
+                          int32_t x0, int32_t y0, int32_t x1, int32_t y1)
+{
+  bool steep = abs(y1 - y0) > abs(x1 - x0);
+  if (steep) { int32_t t = x0; x0 = y0; y0 = t; t = x1; x1 = y1; y1 = t; }
+  if (x0 > x1) { int32_t t = x0; x0 = x1; x1 = t; t = y0; y0 = y1; y1 = t; }
+
+  int32_t dx = x1 - x0, dy = abs(y1 - y0);
+  int32_t err = dx >> 1, ystep = (y0 < y1) ? 1 : -1;
+
+  for (; x0 <= x1; x0++) {
+    int32_t x = steep ? y0 : x0, y = steep ? x0 : y0;
+    if (x >= 0 && x < w && y >= 0 && y < h) map[y * w + x] = 1;
+    err -= dy;
+    if (err < 0) { y0 += ystep; err += dx; }
+  }
+}
+
+// Random long lines, mostly outside, drawn in a random viewport. The pixels drawn
+// must be those of the unclipped line inside the viewport and no others.
+// The viewport is set to all of the w x h area between lines, resetViewport()
+// of a Sprite depends on the width() of the base class.
+static void checkLines(TFT_eSPI *gfx, int32_t w, int32_t h, bool sprite)
+{
+  uint8_t *map = (uint8_t *)malloc(w * h);
+  int32_t bad = 0;
+  srand(1);
+
+  for (int i = 0; i < 300 && map; i++) {
+    int32_t vx = rand() % w, vy = rand() % h;
+    int32_t vw = 1 + rand() % (w - vx), vh = 1 + rand() % (h - vy);
+    // drawPixel() on the screen is the base class one, it does not add the datum
+    bool datum = sprite && (i & 1);
+
+    gfx->setViewport(0, 0, w, h);
+    gfx->fillRect(0, 0, w, h, TFT_BLACK);
+    gfx->setViewport(vx, vy, vw, vh, datum);
+
+    int32_t x0 = rand() % (8 * w) - 4 * w, y0 = rand() % (8 * h) - 4 * h;
+    int32_t x1 = rand() % (8 * w) - 4 * w, y1 = rand() % (8 * h) - 4 * h;
+    if (i % 10 == 0) { x1 = x0 + rand() % 5 - 2; } // Nearly vertical
+    if (i % 10 == 5) { y1 = y0 + rand() % 5 - 2; } // Nearly horizontal
+    gfx->drawLine(x0, y0, x1, y1, TFT_WHITE);
+
+    // The reference in screen coordinates
+    memset(map, 0, w * h);
+    int32_t ox = datum ? vx : 0, oy = datum ? vy : 0;
+    referenceLine(map, w, h, x0 + ox, y0 + oy, x1 + ox, y1 + oy);
+
+    gfx->setViewport(0, 0, w, h);
+    for (int32_t y = 0; y < h; y++) {
+      for (int32_t x = 0; x < w; x++) {
+        bool in = x >= vx && x < vx + vw && y >= vy && y < vy + vh;
+        bool set = sprite ? (spr.readPixel(x, y) != 0) : (host_panel_readPixel(x, y) != 0);
+        if (set != (in && map[y * w + x])) bad++;
+      }
+    }
+  }
+  free(map);
+  CHECK(map != nullptr);
+  CHECK(bad == 0);
+}
+
+// Coverage of the pixels in a w x h area, 255 each one filled
+static int32_t pathCoverage(int32_t x, int32_t y, int32_t w, int32_t h)
+{
+  int32_t sum = 0;
+  for (int32_t j = y; j < y + h; j++)
+    for (int32_t i = x; i < x + w; i++) sum += host_panel_readPixel(i, j) & 0xFF;
+  return sum;
+}
+
+static void checkPath(void)
+{
+  TFT_ePath path;
+
+  // On whole pixels the fill is that of fillRect()
+  tft.fillScreen(TFT_BLACK);
+  path.moveTo(10, 10);
+  path.lineTo(50, 10);
+  path.lineTo(50, 30);
+  path.lineTo(10, 30);
+  CHECK(path.fill(&tft, TFT_WHITE, TFT_BLACK));
+  CHECK(host_panel_readPixel(10, 10) == TFT_WHITE);
+  CHECK(host_panel_readPixel(49, 29) == TFT_WHITE);
+  CHECK(host_panel_readPixel(50, 29) == TFT_BLACK);
+  CHECK(host_panel_readPixel(9, 10) == TFT_BLACK);
+  CHECK(pathCoverage(0, 0, 60, 40) == 40 * 20 * 255);
+
+  // Half a pixel off, the sides are half covered in runs of one window each
+  tft.fillScreen(TFT_BLACK);
+  path.reset();
+  path.moveTo(10.5, 10.5);
+  path.lineTo(50.5, 10.5);
+  path.lineTo(50.5, 30.5);
+  path.lineTo(10.5, 30.5);
+  tft.resetBusStats();
+  CHECK(path.fill(&tft, TFT_WHITE, TFT_BLACK));
+  CHECK(tft.getBusStats().total.windows < 3 * 22);
+  CHECK(host_panel_readPixel(30, 20) == TFT_WHITE);
+  CHECK_NEAR(host_panel_readPixel(30, 10), 0x808080);
+  CHECK_NEAR(host_panel_readPixel(10, 20), 0x808080);
+  CHECK_NEAR(host_panel_readPixel(50, 20), 0x808080);
+  CHECK(abs(pathCoverage(0, 0, 60, 40) - 40 * 20 * 255) < 40 * 255 / 8);
+
+  // A circle of four cubics, the coverage is its area
+  tft.fillScreen(TFT_BLACK);
+  path.reset();
+  float cx = 120, cy = 160, r = 50, k = 0.5523f * r;
+  path.moveTo(cx + r, cy);
+  path.cubicTo(cx + r, cy + k, cx + k, cy + r, cx, cy + r);
+  path.cubicTo(cx - k, cy + r, cx - r, cy + k, cx - r, cy);
+  path.cubicTo(cx - r, cy - k, cx - k, cy - r, cx, cy - r);
+  path.cubicTo(cx + k, cy - r, cx + r, cy - k, cx + r, cy);
+  CHECK(path.fill(&tft, TFT_WHITE, TFT_BLACK));
+  float area = pathCoverage(60, 100, 120, 120) / 255.0f;
+  CHECK(fabsf(area - (float)M_PI * r * r) < 0.01f * (float)M_PI * r * r);
+
+  // Nothing outside a viewport, with and without its datum
+  for (int datum = 0; datum < 2; datum++) {
+    tft.fillScreen(TFT_BLACK);
+    tft.setViewport(40, 50, 60, 70, datum);
+    path.reset();
+    path.moveTo(-100.3f, -100.3f);
+    path.lineTo(400, -100);
+    path.lineTo(400, 500);
+    path.lineTo(-100, 500);
+    CHECK(path.fill(&tft, TFT_WHITE, TFT_BLACK));
+    tft.resetViewport();
+    CHECK(pathCoverage(40, 50, 60, 70) == 60 * 70 * 255);
+    CHECK(pathCoverage(0, 0, tft.width(), tft.height()) == 60 * 70 * 255);
+  }
+
+  // In a Sprite the blended runs go to the Sprite, not the panel
+  tft.fillScreen(TFT_BLACK);
+  spr.createSprite(40, 40);
+  spr.fillSprite(TFT_BLACK);
+  path.reset();
+  path.moveTo(5.5, 5.5);
+  path.lineTo(30.5, 5.5);
+  path.lineTo(30.5, 30.5);
+  CHECK(path.fill(&spr, TFT_WHITE, TFT_BLACK));
+  CHECK(pathCoverage(0, 0, 40, 40) == 0);
+  CHECK(spr.readPixel(28, 8) == TFT_WHITE);
+  rgb_t edge = spr.readPixel(15, 5);
+  CHECK(edge != TFT_BLACK && edge != TFT_WHITE);
+  spr.deleteSprite();
+
+  // An edge that can not be stored fails the fill, nothing is drawn
+  tft.fillScreen(TFT_BLACK);
+  path.reset();
+  path.moveTo(10, 10);
+  for (int i = 0; i < 0x8000 + 10; i++) path.lineTo(10 + (i & 1), 11 + (i & 1));
+  CHECK(!path.fill(&tft, TFT_WHITE, TFT_BLACK));
+  CHECK(pathCoverage(0, 0, 30, 30) == 0);
+
+  // Until reset()
+  path.reset();
+  path.moveTo(10, 10);
+  path.lineTo(20, 10);
+  path.lineTo(20, 20);
+  CHECK(path.fill(&tft, TFT_WHITE, TFT_BLACK));
+  CHECK(host_panel_readPixel(18, 12) == TFT_WHITE);
+  path.deletePath();
+}
+
+int main(int argc, char* argv[])
+{
+  tft.init();
+  tft.setRotation(0);
+
+  checkPolygons();
+  checkLines(&tft, tft.width(), tft.height(), false);
+  checkPath();
+
+  spr.createSprite(90, 70);
+  checkLines(&spr, spr.width(), spr.height(), true);
+  spr.deleteSprite();
+  tft.resetViewport();
+
+  return host_check_result("TFT_Shape_Test");
+}
@@ -0,0 +1,112 @@
+/*
+ Smooth graphics in fixed point against float, on the host virtual panel
+
+ Built twice. TFT_Smooth_Test_Float draws 20000 random wedge lines with
+ the float maths and writes the pixels to the file named by its argument,
+ TFT_Smooth_Test_Fixed draws the same ones with SMOOTH_FIXED and compares.
+
+ A pixel may be one alpha step away. On the 1/32 alpha cutoff one side
+ may draw a faint pixel the other leaves as background.
+ */
+
+#include <TFT_eSPI.h>
+#include "host_check.h"
+
+TFT_eSPI tft = TFT_eSPI();
+
+#define WEDGES 20000
+#define CELL   32
+
+// Deterministic, the same wedges in both builds
+static uint32_t seed = 1;
+static float rnd(float lo, float hi)
+{
+  seed = seed * 1103515245 + 12345;
+  return lo + (hi - lo) * ((seed >> 8) & 0xFFFF) / 65536.0f;
+}
+
+// Draw one screen of wedges in CELL x CELL cells, white on black, returns the count
+static int32_t drawWedges(int32_t left)
+{
+  int32_t n = 0;
+  tft.fillScreen(TFT_BLACK);
+  for (int32_t y = 0; y + CELL <= tft.height() && n < left; y += CELL) {
+    for (int32_t x = 0; x + CELL <= tft.width() && n < left; x += CELL, n++) {
+      float ax = x + rnd(10, 22), ay = y + rnd(10, 22);
+      float bx = ax + rnd(-5, 5), by = ay + rnd(-5, 5);
+      if (n % 16 == 0) { bx = ax; by = ay; } // Spots
+      tft.drawWedgeLine(ax, ay, bx, by, rnd(0.5f, 5), rnd(0.5f, 5), TFT_WHITE, TFT_BLACK);
+    }
+  }
+  return n;
+}
+
+// Green of each pixel, 6 bits on the panel
+static inline int32_t pixelAt(int32_t i)
+{
+  return (host_panel_buffer()[i] >> 8) & 0xFF;
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc < 2) { printf("usage: %s <reference file>\n", argv[0]); return 1; }
+
+  tft.init();
+  tft.setRotation(0);
+  int32_t size = tft.width() * tft.height();
+
+#ifndef SMOOTH_FIXED
+  // Each frame is its lit pixels, index << 8 | green, then 0xFFFFFFFF
+  FILE *f = fopen(argv[1], "wb");
+  CHECK(f != nullptr);
+  for (int32_t left = WEDGES; f && left > 0; ) {
+    left -= drawWedges(left);
+    for (int32_t i = 0; i < size; i++) {
+      uint32_t g = pixelAt(i);
+      if (g) { uint32_t v = i << 8 | g; fwrite(&v, 4, 1, f); }
+    }
+    uint32_t end = 0xFFFFFFFF;
+    fwrite(&end, 4, 1, f);
+  }
+  if (f) fclose(f);
+
+  return host_check_result("TFT_Smooth_Test_Float");
+#else
+  FILE *f = fopen(argv[1], "rb");
+  CHECK(f != nullptr);
+
+  uint8_t *ref = (uint8_t *)malloc(size);
+  int32_t lit = 0, step = 0, cutoff = 0, bad = 0, worst = 0;
+  for (int32_t left = WEDGES; f && ref && left > 0; ) {
+    left -= drawWedges(left);
+
+    memset(ref, 0, size);
+    uint32_t v;
+    while (fread(&v, 4, 1, f) == 1 && v != 0xFFFFFFFF) ref[v >> 8] = v & 0xFF;
+
+    for (int32_t i = 0; i < size; i++) {
+      int32_t g = pixelAt(i), r = ref[i];
+      if (!g && !r) continue;
+      lit++;
+      int32_t d = abs(g - r);
+      if (d > worst) worst = d;
+      if (d == 0) continue;
+      // One alpha step is within one 6 bit green step, 4 in 8 bits, with rounding
+      if (d <= 8) { step++; continue; }
+      // Faint pixels on the alpha cutoff, drawn by one side only
+      if ((!g || !r) && (g + r) <= 16) { cutoff++; continue; }
+      bad++;
+    }
+  }
+
+  printf("%d lit pixels, %d one step, %d on the cutoff, %d more, largest %d\n",
+         (int)lit, (int)step, (int)cutoff, (int)bad, (int)worst);
+  CHECK(lit > WEDGES * 20);
+  CHECK(bad == 0);
+  CHECK(cutoff < lit / 1000);
+  free(ref);
+  if (f) fclose(f);
+
+  return host_check_result("TFT_Smooth_Test_Fixed");
+#endif
+}
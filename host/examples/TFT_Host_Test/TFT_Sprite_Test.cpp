@@ -0,0 +1,164 @@
+/*
+ Sprite push checks on the host virtual panel, built with SPRITE_DIRTY
+
+ pushDirty() sends only the areas written since the last push, touching
+ areas are merged and a full list is merged where it grows least.
+
+ pushDiff() on a 2 frame Sprite sends only the pixels that changed since
+ the previous pushDiff(), runs a few pixels apart in one window.
+
+ Sprites take 565 colours, the panel is read back as rgb_t.
+ */
+
+#include <TFT_eSPI.h>
+#include "host_check.h"
+
+TFT_eSPI    tft = TFT_eSPI();
+TFT_eSprite spr = TFT_eSprite(&tft);
+
+static void checkDirty(void)
+{
+  CHECK(spr.createSprite(100, 80) != nullptr);
+
+  // All of a new Sprite is to be pushed
+  CHECK(spr.getDirtyCount() == 1);
+  spr.fillSprite(color24to16(TFT_BLACK));
+  tft.resetBusStats();
+  spr.pushDirty(50, 60);
+  CHECK(tft.getBusStats().total.pixels == 100 * 80);
+  CHECK(spr.getDirtyCount() == 0);
+
+  // Nothing written, nothing sent
+  tft.resetBusStats();
+  spr.pushDirty(50, 60);
+  CHECK(tft.getBusStats().total.pixels == 0);
+
+  // Two areas apart, one touching and overlapping the first
+  spr.fillRect(10, 10, 20, 20, color24to16(TFT_RED));
+  spr.drawPixel(90, 70, color24to16(TFT_GREEN));
+  spr.fillRect(20, 20, 15, 15, color24to16(TFT_BLUE));
+  CHECK(spr.getDirtyCount() == 2);
+
+  tft.resetBusStats();
+  spr.pushDirty(50, 60);
+  CHECK(tft.getBusStats().total.transactions == 1);
+  CHECK(tft.getBusStats().total.pixels == 25 * 25 + 1);
+  CHECK(host_panel_readPixel(60, 70) == TFT_RED);
+  CHECK(host_panel_readPixel(84, 94) == TFT_BLUE);
+  CHECK(host_panel_readPixel(85, 94) == TFT_BLACK);
+  CHECK(host_panel_readPixel(140, 130) == TFT_GREEN);
+
+  // Clipped to the Sprite
+  spr.fillRect(95, -10, 20, 20, color24to16(TFT_WHITE));
+  tft.resetBusStats();
+  spr.pushDirty(50, 60);
+  CHECK(tft.getBusStats().total.pixels == 5 * 10);
+  CHECK(host_panel_readPixel(149, 60) == TFT_WHITE);
+  CHECK(host_panel_readPixel(149, 70) == TFT_BLACK);
+
+  // A write cleared from the list is not sent
+  spr.fillRect(0, 0, 5, 5, color24to16(TFT_WHITE));
+  spr.clearDirty();
+  spr.pushDirty(50, 60);
+  CHECK(host_panel_readPixel(50, 60) == TFT_BLACK);
+
+  // More areas than the list holds are merged, nothing is lost
+  for (int32_t i = 0; i < SPRITE_DIRTY_RECTS + 4; i++) spr.drawPixel(i * 8, 40, color24to16(TFT_YELLOW));
+  CHECK(spr.getDirtyCount() == SPRITE_DIRTY_RECTS);
+  spr.pushDirty(50, 60);
+  for (int32_t i = 0; i < SPRITE_DIRTY_RECTS + 4; i++) {
+    CHECK(host_panel_readPixel(50 + i * 8, 100) == TFT_YELLOW);
+    CHECK(host_panel_readPixel(51 + i * 8, 100) == TFT_BLACK);
+  }
+
+  spr.deleteSprite();
+}
+
+static void checkDiff(void)
+{
+  CHECK(spr.createSprite(100, 80, 2) != nullptr);
+  host_panel_fill(TFT_MAGENTA);
+
+  // The first is pushed whole
+  spr.fillSprite(color24to16(TFT_BLACK));
+  tft.resetBusStats();
+  spr.pushDiff(50, 60);
+  CHECK(tft.getBusStats().total.pixels == 100 * 80);
+  CHECK(host_panel_readPixel(149, 139) == TFT_BLACK);
+
+  // Drawing continues on what was pushed, unchanged it sends nothing
+  tft.resetBusStats();
+  spr.pushDiff(50, 60);
+  CHECK(tft.getBusStats().total.pixels == 0);
+
+  // A pixel, a run on two rows and two pixels close enough for one window
+  spr.drawPixel(5, 5, color24to16(TFT_RED));
+  spr.fillRect(20, 30, 10, 2, color24to16(TFT_BLUE));
+  spr.drawPixel(40, 50, color24to16(TFT_GREEN));
+  spr.drawPixel(44, 50, color24to16(TFT_GREEN));
+  tft.resetBusStats();
+  spr.pushDiff(50, 60);
+  CHECK(tft.getBusStats().total.windows == 4);
+  CHECK(tft.getBusStats().total.pixels == 1 + 2 * 10 + 5);
+  CHECK(host_panel_readPixel(55, 65) == TFT_RED);
+  CHECK(host_panel_readPixel(79, 91) == TFT_BLUE);
+  CHECK(host_panel_readPixel(90, 110) == TFT_GREEN);
+  CHECK(host_panel_readPixel(92, 110) == TFT_BLACK);
+  CHECK(host_panel_readPixel(94, 110) == TFT_GREEN);
+
+  // Pixels far apart on a row go in windows of their own
+  spr.drawPixel(0, 70, color24to16(TFT_WHITE));
+  spr.drawPixel(SPRITE_DIFF_GAP + 1, 70, color24to16(TFT_WHITE));
+  tft.resetBusStats();
+  spr.pushDiff(50, 60);
+  CHECK(tft.getBusStats().total.windows == 2);
+  CHECK(tft.getBusStats().total.pixels == 2);
+
+  // Drawn over with what it held, the frame that was pushed is unchanged
+  spr.drawPixel(40, 50, color24to16(TFT_GREEN));
+  tft.resetBusStats();
+  spr.pushDiff(50, 60);
+  CHECK(tft.getBusStats().total.pixels == 0);
+
+  // Put back, only the erased pixel is sent
+  spr.drawPixel(5, 5, color24to16(TFT_BLACK));
+  tft.resetBusStats();
+  spr.pushDiff(50, 60);
+  CHECK(tft.getBusStats().total.pixels == 1);
+  CHECK(host_panel_readPixel(55, 65) == TFT_BLACK);
+  CHECK(host_panel_readPixel(79, 91) == TFT_BLUE);
+
+  // The panel shows the last frame
+  int32_t bad = 0;
+  for (int32_t y = 0; y < 80; y++) {
+    for (int32_t x = 0; x < 100; x++) {
+      rgb_t c = host_panel_readPixel(50 + x, 60 + y);
+      bool lit = (x >= 20 && x < 30 && y >= 30 && y < 32) || (y == 50 && (x == 40 || x == 44)) ||
+                 (y == 70 && (x == 0 || x == SPRITE_DIFF_GAP + 1));
+      if (lit == (c == TFT_BLACK)) bad++;
+    }
+  }
+  CHECK(bad == 0);
+
+  // A Sprite of one frame is pushed whole
+  spr.deleteSprite();
+  CHECK(spr.createSprite(100, 80) != nullptr);
+  tft.resetBusStats();
+  spr.pushDiff(50, 60);
+  spr.pushDiff(50, 60);
+  CHECK(tft.getBusStats().total.pixels == 2 * 100 * 80);
+
+  spr.deleteSprite();
+}
+
+int main(int argc, char* argv[])
+{
+  tft.init();
+  tft.setRotation(0);
+  host_panel_fill(TFT_MAGENTA);
+
+  checkDirty();
+  checkDiff();
+
+  return host_check_result("TFT_Sprite_Test");
+}
@@ -0,0 +1,95 @@
+/*
+ Strip ring checks on the host virtual panel, built with STRIP_RENDER
+
+ TFT_eStrips::render() draws a scene on a second thread into a ring of
+ Sprite strips and pushes them from this one. The panel then shows what
+ pushBanded() through one band shows, with one window per strip, for the
+ smallest and the largest ring. Shapes cross the strip edges.
+
+ Sprites take 565 colours, the panel is read back as rgb_t.
+ */
+
+#include <TFT_eSPI.h>
+#include "host_check.h"
+
+TFT_eSPI    tft = TFT_eSPI();
+TFT_eSprite spr = TFT_eSprite(&tft);
+TFT_eStrips strips = TFT_eStrips(&tft);
+
+#define SCENE_W 120
+#define SCENE_H 150  // Not a multiple of the strip height
+#define STRIP_H 24
+
+// Each shape crosses at least one strip edge, calls counts the strips drawn
+static void drawScene(TFT_eSprite *band, void *param)
+{
+  std::atomic<int32_t> *calls = (std::atomic<int32_t> *)param;
+  if (calls) (*calls)++;
+
+  band->fillRect(10, 20, 40, 30, color24to16(TFT_RED));
+  band->drawRect(60, 25, 50, 50, color24to16(TFT_WHITE));
+  band->fillCircle(60, 96, 20, color24to16(TFT_BLUE));
+  band->drawLine(0, 0, SCENE_W - 1, SCENE_H - 1, color24to16(TFT_GREEN));
+  band->fillTriangle(5, 120, 50, 140, 20, 160, color24to16(TFT_YELLOW));
+  band->drawFastVLine(115, 10, 200, color24to16(TFT_CYAN));
+  band->drawPixel(100, 143, color24to16(TFT_WHITE));
+  band->drawPixel(100, 144, color24to16(TFT_WHITE));
+}
+
+static void checkRing(uint8_t count, const rgb_t *ref)
+{
+  CHECK(strips.createStrips(SCENE_W, STRIP_H, count));
+  host_panel_fill(TFT_MAGENTA);
+
+  std::atomic<int32_t> calls(0);
+  tft.resetBusStats();
+  CHECK(strips.render(30, 40, SCENE_H, drawScene, &calls));
+
+  int32_t n = (SCENE_H + STRIP_H - 1) / STRIP_H;
+  CHECK(calls == n);
+  CHECK(tft.getBusStats().total.windows == (uint32_t)n);
+  CHECK(tft.getBusStats().total.pixels == SCENE_W * SCENE_H);
+
+  int32_t bad = 0;
+  for (int32_t y = 0; y < SCENE_H; y++)
+    for (int32_t x = 0; x < SCENE_W; x++)
+      if (host_panel_readPixel(30 + x, 40 + y) != ref[y * SCENE_W + x]) bad++;
+  CHECK(bad == 0);
+
+  // Nothing is drawn past the scene
+  CHECK(host_panel_readPixel(145, 40 + SCENE_H) == TFT_MAGENTA);
+
+  // A second render of the same ring draws it again
+  host_panel_fill(TFT_MAGENTA);
+  CHECK(strips.render(30, 40, SCENE_H, drawScene));
+  CHECK(host_panel_readPixel(30 + 100, 40 + 144) == TFT_WHITE);
+  CHECK(host_panel_readPixel(30 + 40, 40 + 30) == TFT_RED);
+
+  strips.deleteStrips();
+}
+
+int main(int argc, char* argv[])
+{
+  tft.init();
+  tft.setRotation(0);
+
+  // Drawn by pushBanded() through a band of another height for the reference
+  CHECK(spr.createSprite(SCENE_W, 32) != nullptr);
+  host_panel_fill(TFT_MAGENTA);
+  CHECK(spr.pushBanded(30, 40, SCENE_H, drawScene));
+  spr.deleteSprite();
+  rgb_t *ref = (rgb_t *)malloc(SCENE_W * SCENE_H * sizeof(rgb_t));
+  CHECK(ref != nullptr);
+  if (!ref) return host_check_result("TFT_Strip_Test");
+  for (int32_t y = 0; y < SCENE_H; y++)
+    for (int32_t x = 0; x < SCENE_W; x++) ref[y * SCENE_W + x] = host_panel_readPixel(30 + x, 40 + y);
+
+  checkRing(2, ref);
+  checkRing(STRIP_RING_MAX, ref);
+
+  // No ring, nothing is drawn
+  CHECK(!strips.render(30, 40, SCENE_H, drawScene));
+
+  free(ref);
+  return host_check_result("TFT_Strip_Test");
+}
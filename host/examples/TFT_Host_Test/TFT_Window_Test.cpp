@@ -0,0 +1,112 @@
+/*
+ Address window cache checks on the host virtual panel, built with TFT_WINDOW_CACHE
+
+ A window is kept as it was asked for, pixels past its end wrap back to
+ its start, and a window is only skipped when the panel is already there,
+ in this transaction or an earlier one. When only the rows or only the
+ columns change, only they are sent.
+ */
+
+#include <TFT_eSPI.h>
+#include "host_check.h"
+
+TFT_eSPI tft = TFT_eSPI();
+
+int main(int argc, char* argv[])
+{
+  tft.init();
+  tft.setRotation(0);
+  tft.fillScreen(TFT_BLACK);
+
+  // 12 pixels in a 4 x 2 window, the last 4 wrap over the first row
+  tft.setAddrWindow(10, 10, 4, 2);
+  tft.startWrite();
+  for (int i = 0; i < 12; i++) tft.pushColor(i < 8 ? TFT_RED : TFT_GREEN);
+  tft.endWrite();
+  for (int i = 10; i < 14; i++) {
+    CHECK(host_panel_readPixel(i, 10) == TFT_GREEN);
+    CHECK(host_panel_readPixel(i, 11) == TFT_RED);
+    CHECK(host_panel_readPixel(i, 12) == TFT_BLACK);
+  }
+
+  // The rest of a window continues it without a new one
+  uint16_t line[8];
+  for (int i = 0; i < 8; i++) line[i] = 0xFFFF;
+  tft.startWrite();
+  tft.setAddrWindow(20, 20, 4, 4);
+  tft.pushPixels(line, 8);
+  tft.resetBusStats();
+  tft.setAddrWindow(20, 22, 4, 2);
+  CHECK(tft.getBusStats().total.windows == 0);
+  tft.pushPixels(line, 8);
+
+  // Rows below the window need a new one
+  tft.setAddrWindow(20, 24, 4, 2);
+  CHECK(tft.getBusStats().total.windows == 1);
+  tft.pushPixels(line, 8);
+  tft.endWrite();
+  for (int j = 20; j < 26; j++) CHECK(host_panel_readPixel(21, j) == TFT_WHITE);
+  CHECK(host_panel_readPixel(21, 26) == TFT_BLACK);
+
+  // Back over the same rows in a new transaction
+  tft.fillRect(30, 30, 4, 4, TFT_BLUE);
+  tft.fillRect(30, 32, 4, 2, TFT_YELLOW);
+  CHECK(host_panel_readPixel(31, 31) == TFT_BLUE);
+  CHECK(host_panel_readPixel(31, 33) == TFT_YELLOW);
+
+  // The window lasts across transactions
+  tft.startWrite();
+  tft.setAddrWindow(40, 40, 4, 4);
+  tft.pushPixels(line, 8);
+  tft.endWrite();
+  tft.resetBusStats();
+  tft.startWrite();
+  tft.setAddrWindow(40, 42, 4, 2);
+  tft.pushPixels(line, 8);
+  tft.endWrite();
+  CHECK(tft.getBusStats().total.windows == 0);
+  CHECK(tft.getBusStats().total.transactions == 1);
+  CHECK(host_panel_readPixel(43, 43) == TFT_WHITE);
+
+  // Rows only in the same columns, columns only in the same rows
+  uint32_t cols = host_panel_columnAddrs(), rows = host_panel_rowAddrs();
+  tft.fillRect(50, 50, 4, 4, TFT_RED);
+  tft.fillRect(50, 60, 4, 2, TFT_GREEN);
+  CHECK(host_panel_columnAddrs() == cols + 1);
+  CHECK(host_panel_rowAddrs() == rows + 2);
+  tft.fillRect(60, 60, 2, 2, TFT_BLUE);
+  CHECK(host_panel_columnAddrs() == cols + 2);
+  CHECK(host_panel_rowAddrs() == rows + 2);
+  CHECK(host_panel_readPixel(53, 53) == TFT_RED);
+  CHECK(host_panel_readPixel(53, 61) == TFT_GREEN);
+  CHECK(host_panel_readPixel(61, 61) == TFT_BLUE);
+  CHECK(host_panel_readPixel(54, 60) == TFT_BLACK);
+  CHECK(host_panel_readPixel(59, 61) == TFT_BLACK);
+
+  // A vertical line down one column sends only its rows after the first
+  cols = host_panel_columnAddrs();
+  for (int j = 70; j < 80; j += 2) tft.drawFastVLine(70, j, 1, TFT_WHITE);
+  CHECK(host_panel_columnAddrs() == cols + 1);
+  for (int j = 70; j < 80; j++) CHECK(host_panel_readPixel(70, j) == ((j & 1) ? TFT_BLACK : TFT_WHITE));
+
+  // A read or a rotation clears it
+  tft.startWrite();
+  tft.setAddrWindow(40, 40, 4, 4);
+  tft.pushPixels(line, 8);
+  tft.endWrite();
+  tft.readPixel(0, 0);
+  tft.resetBusStats();
+  tft.setAddrWindow(40, 42, 4, 2);
+  CHECK(tft.getBusStats().total.windows == 1);
+
+  tft.startWrite();
+  tft.setAddrWindow(40, 40, 4, 4);
+  tft.pushPixels(line, 8);
+  tft.endWrite();
+  tft.setRotation(0);
+  tft.resetBusStats();
+  tft.setAddrWindow(40, 42, 4, 2);
+  CHECK(tft.getBusStats().total.windows == 1);
+
+  return host_check_result("TFT_Window_Test");
+}
@@ -0,0 +1,47 @@
+/*
+  Checks for the host tests, a failed check is printed and counted,
+  main() returns host_check_result() so CTest sees the failures.
+*/
+
+#pragma once
+
+#include <TFT_API.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static int host_check_failed = 0;
+
+#define CHECK(cond)                                                        \
+  do {                                                                     \
+    if (!(cond)) {                                                         \
+      printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond);      \
+      host_check_failed++;                                                 \
+    }                                                                      \
+  } while (0)
+
+// Colours are equal to within tol on each of R, G and B,
+// 565 and 666 panels do not keep the same low bits
+static inline bool host_near(rgb_t a, rgb_t b, int tol = 8)
+{
+  for (int s = 0; s < 24; s += 8) {
+    if (abs((int)((a >> s) & 0xFF) - (int)((b >> s) & 0xFF)) > tol) return false;
+  }
+  return true;
+}
+
+#define CHECK_NEAR(a, b)                                                   \
+  do {                                                                     \
+    rgb_t a_ = (a), b_ = (b);                                              \
+    if (!host_near(a_, b_)) {                                              \
+      printf("%s:%d: CHECK_NEAR(%s, %s) failed: %06x %06x\n",              \
+             __FILE__, __LINE__, #a, #b, (unsigned)a_, (unsigned)b_);      \
+      host_check_failed++;                                                 \
+    }                                                                      \
+  } while (0)
+
+static inline int host_check_result(const char* name)
+{
+  if (host_check_failed) printf("%s: %d checks failed\n", name, host_check_failed);
+  else printf("%s: passed\n", name);
+  return host_check_failed ? 1 : 0;
+}
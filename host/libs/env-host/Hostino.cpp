@@ -0,0 +1,55 @@
+/*
+  Environment for host (Linux) builds
+*/
+
+#include "env.h"
+
+#include <time.h>
+
+// Sketch entry points, main() calls setup() once, then loop() until exit(),
+// weak, so the sketches with their own main() do not need them
+void setup() __attribute__((weak));
+void loop() __attribute__((weak));
+
+static uint64_t now_us()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static const uint64_t start_us = now_us();
+
+uint32_t millis()
+{
+  return (uint32_t)((now_us() - start_us) / 1000);
+}
+
+uint32_t micros()
+{
+  return (uint32_t)(now_us() - start_us);
+}
+
+void delay(uint32_t ms)
+{
+  delayMicroseconds(ms * 1000);
+}
+
+void delayMicroseconds(uint32_t us)
+{
+  struct timespec ts;
+  ts.tv_sec = us / 1000000;
+  ts.tv_nsec = (us % 1000000) * 1000;
+  nanosleep(&ts, 0);
+}
+
+void yield()
+{
+}
+
+int __attribute__((weak)) main()
+{
+  if (setup) setup();
+  if (loop) for (;;) loop();
+  return 0;
+}
@@ -0,0 +1,45 @@
+/*
+  Environment for host (Linux) builds
+
+  Supplies the small part of the Arduino API the library relies on,
+  String and Print come from the portable ArduinoCore API in env-tsd.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+
+#include <api/String.h>
+#include <api/Print.h>
+
+using arduino::String;
+using arduino::Print;
+
+// ---------------------------- flash ----------------------------------------
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(addr)   (*(const uint8_t *)(addr))
+#define pgm_read_word(addr)   (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr)  (*(const uintptr_t *)(addr)) // font table pointers, 64 bit here
+#define pgm_read_ptr(addr)    (*(void* const *)(addr))
+
+// ---------------------------- time -----------------------------------------
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+// ---------------------------- helpers --------------------------------------
+
+#ifndef min
+  #define min(a,b) ((a)<(b)?(a):(b))
+#endif
+#ifndef max
+  #define max(a,b) ((a)>(b)?(a):(b))
+#endif
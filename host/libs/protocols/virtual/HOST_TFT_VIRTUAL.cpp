@@ -0,0 +1,356 @@
+/*
+  Virtual panel for host (Linux) builds
+*/
+
+#include "HOST_TFT_VIRTUAL.h"
+
+#if defined(TFT_VIRTUAL_WRITE)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+static rgb_t* panel = 0;
+static int16_t panel_w = 0;
+static int16_t panel_h = 0;
+
+// address window, inclusive, and the write/read pointer
+static int16_t win_x0 = 0, win_y0 = 0, win_x1 = 0, win_y1 = 0;
+static int16_t ptr_x = 0, ptr_y = 0;
+
+static bool writing = false;
+static bool reading = false;
+
+// column and row address commands sent
+static uint32_t columnAddrs = 0, rowAddrs = 0;
+
+// asynchronous send in progress, see tft_sendMDTBuffer16Async
+// Never destroyed, the detached worker still waits on them at exit
+static std::mutex& async_mutex = *new std::mutex;
+static std::condition_variable& async_cv = *new std::condition_variable;
+static std::atomic<bool> async_busy(false);
+static bool async_started = false;
+static const uint8_t* async_p = 0;
+static int32_t async_len = 0;
+
+static void panel_alloc()
+{
+  if (!panel) {
+    host_panel_setSize(TFT_WIDTH, TFT_HEIGHT);
+  }
+}
+
+/***************************************************************************************
+** Function name:           mdt_to_rgb
+** Description:             Decode a bus color back to rgb_t
+***************************************************************************************/
+static inline rgb_t mdt_to_rgb(const mdt_t c)
+{
+#if defined(COLOR_565)
+  uint32_t r = (c >> 11) & 0x1F, g = (c >> 5) & 0x3F, b = c & 0x1F;
+  return ((r << 3 | r >> 2) << 16) | ((g << 2 | g >> 4) << 8) | (b << 3 | b >> 2);
+#else
+  return c & 0xFFFFFF;
+#endif
+}
+
+/***************************************************************************************
+** Function name:           store
+** Description:             Store a pixel at the write pointer and advance it
+***************************************************************************************/
+static inline void store(const rgb_t color)
+{
+  if (ptr_x >= 0 && ptr_x < panel_w && ptr_y >= 0 && ptr_y < panel_h) {
+    panel[ptr_y * panel_w + ptr_x] = color;
+  }
+  if (++ptr_x > win_x1) {
+    ptr_x = win_x0;
+    if (++ptr_y > win_y1) ptr_y = win_y0;
+  }
+}
+
+/***************************************************************************************
+** Function name:           fetch
+** Description:             Read a pixel at the read pointer and advance it
+***************************************************************************************/
+static inline rgb_t fetch()
+{
+  rgb_t color = 0;
+  if (ptr_x >= 0 && ptr_x < panel_w && ptr_y >= 0 && ptr_y < panel_h) {
+    color = panel[ptr_y * panel_w + ptr_x];
+  }
+  if (++ptr_x > win_x1) {
+    ptr_x = win_x0;
+    if (++ptr_y > win_y1) ptr_y = win_y0;
+  }
+  return color;
+}
+
+#if !defined(COLOR_565)
+// Bytes of a 666 pixel not yet complete, from the end of the last buffer
+static uint8_t part[3];
+static int32_t partLen = 0;
+#endif
+
+/***************************************************************************************
+** Function name:           storeBuffer16
+** Description:             Store the bytes of 2 * len, decoded as the panel would
+***************************************************************************************/
+static void storeBuffer16(const uint8_t* p, int32_t len)
+{
+#if defined(COLOR_565)
+  // 565 pixels, high byte first as they go on the wire
+  while (len-- > 0) {
+    uint16_t c = (p[0] << 8) | p[1];
+    p += 2;
+    uint32_t r = (c >> 11) & 0x1F, g = (c >> 5) & 0x3F, b = c & 0x1F;
+    store(((r << 3 | r >> 2) << 16) | ((g << 2 | g >> 4) << 8) | (b << 3 | b >> 2));
+  }
+#else
+  // 666 pixels, three bytes R, G, B
+  for (int32_t n = len * 2; n > 0; n--) {
+    part[partLen++] = *p++;
+    if (partLen == 3) {
+      store(((part[0] & 0xFC) << 16) | ((part[1] & 0xFC) << 8) | (part[2] & 0xFC));
+      partLen = 0;
+    }
+  }
+#endif
+}
+
+/***************************************************************************************
+** Function name:           async_worker
+** Description:             Store the buffers handed over by tft_sendMDTBuffer16Async
+***************************************************************************************/
+static void async_worker()
+{
+  std::unique_lock<std::mutex> lock(async_mutex);
+  for (;;) {
+    async_cv.wait(lock, [] { return async_p != 0; });
+    const uint8_t* p = async_p;
+    int32_t len = async_len;
+    lock.unlock();
+    storeBuffer16(p, len);
+    lock.lock();
+    async_p = 0;
+    async_busy = false;
+    async_cv.notify_all();
+  }
+}
+
+// ---------------------------- write ----------------------------------------
+
+/***************************************************************************************
+** Function name:           ramWrite
+** Description:             Start a RAM write at the window origin
+***************************************************************************************/
+static void ramWrite()
+{
+  ptr_x = win_x0;
+  ptr_y = win_y0;
+#if !defined(COLOR_565)
+  partLen = 0;   // A new RAM write starts on a pixel
+#endif
+}
+
+void tft_startWrite()
+{
+  tft_sendWait();
+  panel_alloc();
+  writing = true;
+}
+
+void tft_endWrite()
+{
+  tft_sendWait();
+  writing = false;
+}
+
+void tft_sendCmd(const uint8_t cmd)
+{
+  // no controller registers on the virtual panel
+}
+
+void tft_sendCmdData(const uint8_t cmd, const uint8_t* data, const int16_t size)
+{
+  // no controller registers on the virtual panel
+}
+
+void tft_writeAddrWindow(const int16_t x, const int16_t y, const int16_t w, const int16_t h)
+{
+  tft_writeAddrColumns(x, w);
+  tft_writeAddrRows(y, h);
+}
+
+void tft_writeAddrColumns(const int16_t x, const int16_t w)
+{
+  tft_sendWait();
+  panel_alloc();
+  win_x0 = x;
+  win_x1 = x + w - 1;
+  columnAddrs++;
+  ramWrite();
+}
+
+void tft_writeAddrRows(const int16_t y, const int16_t h)
+{
+  tft_sendWait();
+  panel_alloc();
+  win_y0 = y;
+  win_y1 = y + h - 1;
+  rowAddrs++;
+  ramWrite();
+}
+
+void tft_sendMDTColor(const mdt_t c)
+{
+  tft_sendWait();
+  store(mdt_to_rgb(c));
+}
+
+void tft_sendMDTColor(const mdt_t c, int32_t len)
+{
+  tft_sendWait();
+  rgb_t color = mdt_to_rgb(c);
+  while (len-- > 0) store(color);
+}
+
+void tft_sendMDTBuffer16(const uint8_t* p, int32_t len)
+{
+  tft_sendWait();
+  storeBuffer16(p, len);
+}
+
+void tft_sendMDTBuffer16Async(const uint8_t* p, int32_t len)
+{
+  tft_sendWait();
+  std::lock_guard<std::mutex> lock(async_mutex);
+  if (!async_started) {
+    std::thread(async_worker).detach();
+    async_started = true;
+  }
+  async_p = p;
+  async_len = len;
+  async_busy = true;
+  async_cv.notify_all();
+}
+
+void tft_sendWait()
+{
+  if (!async_busy) return;
+  std::unique_lock<std::mutex> lock(async_mutex);
+  async_cv.wait(lock, [] { return !async_busy; });
+}
+
+// ---------------------------- read -----------------------------------------
+
+void tft_startReading()
+{
+  tft_sendWait();
+  panel_alloc();
+  reading = true;
+}
+
+void tft_endReading()
+{
+  reading = false;
+}
+
+void tft_readAddrWindow(const int16_t x, const int16_t y, const int16_t w, const int16_t h)
+{
+  tft_writeAddrWindow(x, y, w, h);
+}
+
+rgb_t tft_readMDTColor()
+{
+  tft_sendWait();
+  return fetch();
+}
+
+// ---------------------------- host side ------------------------------------
+
+void host_panel_setSize(const int16_t w, const int16_t h)
+{
+  tft_sendWait();
+  free(panel);
+  panel_w = w > 0 ? w : 0;
+  panel_h = h > 0 ? h : 0;
+  panel = (rgb_t*)calloc((size_t)panel_w * panel_h + 1, sizeof(rgb_t));
+  win_x0 = win_y0 = ptr_x = ptr_y = 0;
+  win_x1 = panel_w - 1;
+  win_y1 = panel_h - 1;
+  columnAddrs = rowAddrs = 0;
+}
+
+int16_t host_panel_width()
+{
+  panel_alloc();
+  return panel_w;
+}
+
+int16_t host_panel_height()
+{
+  panel_alloc();
+  return panel_h;
+}
+
+rgb_t* host_panel_buffer()
+{
+  tft_sendWait();
+  panel_alloc();
+  return panel;
+}
+
+rgb_t host_panel_readPixel(const int16_t x, const int16_t y)
+{
+  tft_sendWait();
+  panel_alloc();
+  if (x < 0 || x >= panel_w || y < 0 || y >= panel_h) return 0;
+  return panel[y * panel_w + x];
+}
+
+void host_panel_fill(const rgb_t color)
+{
+  tft_sendWait();
+  panel_alloc();
+  for (int32_t i = 0, n = (int32_t)panel_w * panel_h; i < n; ++i) panel[i] = color;
+}
+
+bool host_panel_writing()
+{
+  return writing;
+}
+
+uint32_t host_panel_columnAddrs()
+{
+  return columnAddrs;
+}
+
+uint32_t host_panel_rowAddrs()
+{
+  return rowAddrs;
+}
+
+bool host_panel_savePPM(const char* path)
+{
+  tft_sendWait();
+  panel_alloc();
+  FILE* f = fopen(path, "wb");
+  if (!f) return false;
+  fprintf(f, "P6\n%d %d\n255\n", panel_w, panel_h);
+  uint8_t rgb[3];
+  for (int32_t i = 0, n = (int32_t)panel_w * panel_h; i < n; ++i) {
+    rgb[0] = panel[i] >> 16;
+    rgb[1] = panel[i] >> 8;
+    rgb[2] = panel[i];
+    fwrite(rgb, 1, 3, f);
+  }
+  return fclose(f) == 0;
+}
+
+#endif
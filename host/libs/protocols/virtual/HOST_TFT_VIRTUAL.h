@@ -0,0 +1,107 @@
+/*
+  Virtual panel for host (Linux) builds
+
+  Implements the TFT API over an in-memory framebuffer,
+  with the same address window and auto-increment semantics
+  as a real display controller:
+
+    - tft_writeAddrWindow sets the window and moves the write pointer
+      to its top left corner,
+    - every pixel sent is stored at the write pointer, which then
+      advances left to right, top to bottom, and wraps back
+      to the window origin when the window is filled,
+    - pixels outside the panel are dropped but still advance the pointer.
+
+  The framebuffer holds rgb_t (0x00RRGGBB) values, bus colors
+  are decoded in the same format they are encoded by mdt_color.
+*/
+
+#pragma once
+
+#include <Setup.h>
+
+#if defined(TFT_VIRTUAL_WRITE)
+
+#include <stdint.h>
+#include <rgb.h>
+
+// ---------------------------- bus color ------------------------------------
+
+#if defined(COLOR_565)
+  typedef uint16_t mdt_t;     // 565, high byte first on the wire
+#else
+  typedef uint32_t mdt_t;     // 666 carried in the three lowest bytes R, G, B
+#endif
+
+inline mdt_t mdt_color(const rgb_t color)
+{
+#if defined(COLOR_565)
+  return ((color >> 8) & 0xF800) | ((color >> 5) & 0x07E0) | ((color >> 3) & 0x001F);
+#else
+  return color & 0xFCFCFC;
+#endif
+}
+
+// ---------------------------- write ----------------------------------------
+
+void tft_startWrite();
+void tft_endWrite();
+
+void tft_sendCmd(const uint8_t cmd);
+void tft_sendCmdData(const uint8_t cmd, const uint8_t* data, const int16_t size);
+
+void tft_writeAddrWindow(const int16_t x, const int16_t y, const int16_t w, const int16_t h);
+
+// Only the columns (CASET) or only the rows (PASET) of the window, the other axis is
+// kept, then the RAM write: the write pointer moves to the top left of the new window
+#define TFT_WRITE_ADDR_AXES
+
+void tft_writeAddrColumns(const int16_t x, const int16_t w);
+void tft_writeAddrRows(const int16_t y, const int16_t h);
+
+void tft_sendMDTColor(const mdt_t c);
+void tft_sendMDTColor(const mdt_t c, int32_t len);
+
+// 2 * len bytes as they are, 565 pixels high byte first, or on a 666 panel
+// R, G, B bytes, a pixel may be split between two calls
+void tft_sendMDTBuffer16(const uint8_t* p, int32_t len);
+
+// Asynchronous send, the pixels are stored by a worker thread as a DMA channel would
+// send them, p must not change until tft_sendWait() returns. Every other call waits
+// for the send first.
+#define TFT_SEND_ASYNC
+
+void tft_sendMDTBuffer16Async(const uint8_t* p, int32_t len);
+void tft_sendWait();
+
+// ---------------------------- read -----------------------------------------
+
+void tft_startReading();
+void tft_endReading();
+
+void tft_readAddrWindow(const int16_t x, const int16_t y, const int16_t w, const int16_t h);
+rgb_t tft_readMDTColor();
+
+// ---------------------------- host side ------------------------------------
+
+// Panel geometry, defaults to TFT_WIDTH x TFT_HEIGHT, contents are cleared
+void host_panel_setSize(const int16_t w, const int16_t h);
+int16_t host_panel_width();
+int16_t host_panel_height();
+
+// Direct access to the framebuffer, bypasses the window
+rgb_t* host_panel_buffer();
+rgb_t host_panel_readPixel(const int16_t x, const int16_t y);
+void host_panel_fill(const rgb_t color);
+
+// A write transaction is open, between tft_startWrite and tft_endWrite
+bool host_panel_writing();
+
+// Column and row address commands sent since host_panel_setSize
+uint32_t host_panel_columnAddrs();
+uint32_t host_panel_rowAddrs();
+
+// Save the framebuffer as binary PPM (P6), returns false on I/O error
+bool host_panel_savePPM(const char* path);
+
+#endif
@@ -0,0 +1,71 @@
+/*
+  User setup for host (Linux) virtual panel
+*/
+
+// -------------------------------TFT driver ----------------------------------
+
+// the virtual panel has no controller, the driver only decides
+// what the library code compiled for it, e.g. GC9A01 paths
+
+  #define ILI9341       // behave as 2.4" TFT SPI 240x320
+
+// -------------------------------TFT params ----------------------------------
+
+#if !defined(TFT_HOST_666)
+  #define COLOR_565     // comment it for 666 colors, or build with TFT_HOST_666
+#endif
+
+// don't enable OVERLAID if you are not shure that absolutelly
+// all colors comes from RGB macro, even 0 is not a BLACK
+//  #define OVERLAID      // enable overlaid in writeColor and writeChar
+
+// select one of
+  #define TFT_VIRTUAL_WRITE
+
+// count windows, pixels, reads and transactions, see getBusStats()
+  #define TFT_BUS_STATS
+
+// skip setWindow() when the panel window and write pointer are already right
+//  #define TFT_WINDOW_CACHE
+
+// keep the write transaction open between drawing calls, see endBatch()
+//  #define TFT_AUTO_BATCH
+
+// bus the wire time is predicted for, see getBusTime(), SPI by default
+//  #define TFT_BUS_MODEL_PIO_SPI
+//  #define TFT_PIO_SPI_WRITE_DIV   2
+//  #define TFT_PIO_SPI_READ_DIV    5
+//  #define TFT_BUS_MODEL_8BITP
+//  #define TFT_8BITP_WRITE_SPEED  15 * 1000 * 1000       // write strobes per second
+
+// smooth graphics in Q16.16 fixed point, see TFT_GFX.h
+//  #define SMOOTH_FIXED
+
+// keep a copy of the panel in RAM for readPixel(), see createShadow()
+//  #define TFT_SHADOW
+//  #define TFT_SHADOW_DEPTH 8
+//  #define TFT_SHADOW_TILE 16    // tiles sent by flushShadow(), see setShadowDefer()
+
+// Display screen size
+  #define TFT_WIDTH  240
+  #define TFT_HEIGHT 320
+
+// The bus is simulated, speeds are those of the board being modelled
+  #define TFT_SPI_SETUP_SPEED     2 * 1000 * 1000          // 2 MHz
+  #define TFT_SPI_WRITE_SPEED    60 * 1000 * 1000          // 60 MHz
+  #define TFT_SPI_READ_SPEED     20 * 1000 * 1000          //  20 MHz
+
+  #define TFT_REV 0
+
+// ---------------------------- Touch Screen ----------------------------------
+
+// no touch on the virtual panel
+
+  #define TOUCH_REV 0
+  #define TOUCH_ROTATION touch_9xxx
+
+// TouchScreen edges of the display in range of 0..4095
+  #define TS_LEFT 150
+  #define TS_TOP 400
+  #define TS_RIGHT 150
+  #define TS_BOTTOM 150
@@ -0,0 +1,9 @@
+/*
+  TFT API for host (Linux)
+*/
+
+#pragma once
+
+#include <Setup.h>
+
+  #include <HOST_TFT_VIRTUAL.h>
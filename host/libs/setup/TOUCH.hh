@@ -0,0 +1 @@
+// no touch on the virtual panel
@@ -0,0 +1,524 @@
+/*
+ Benchmark of the graphics primitives, fonts and Sprites
+
+ In the spirit of Bodmer's graphicstest, but every result is printed
+ as one JSON document, so the runs of different Setup_*.h configurations
+ or library versions can be compared by a script:
+
+   {"library":"2.5.43","bus":"SPI","color":"565","math":"fixed","shadow":"none",
+    "width":240,"height":320,
+    "results":[{"name":"fillRect","ops":200,"us":1234,
+                "windows":200,"pixels":.., "reads":0,"transactions":200,
+                "wire_us":.., ...}, ...]}
+
+ The bus counters, and the wire time predicted from them for the bus
+ of the Setup header (see getBusTime), are only printed when TFT_BUS_STATS
+ is defined in the Setup header, the wall time is always printed.
+
+ "math" is the smooth graphics maths, see SMOOTH_FIXED in TFT_GFX.h, run
+ once without and once with SMOOTH_FIXED defined in the Setup header to
+ compare the smooth graphics timings. The host builds both,
+ TFT_Benchmark and TFT_Benchmark_Fixed.
+
+ "shadow" is the depth of the shadow framebuffer when TFT_SHADOW is defined
+ in the Setup header, "none" otherwise. With it the read-back tests, e.g.
+ drawWedgeLineRead, make no bus reads, and frameDeferred draws the frames
+ of the frame test into the shadow, sending only their dirty tiles.
+
+ All drawing is deterministic, so the runs are comparable.
+ */
+
+#include <TFT_eSPI.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+TFT_eSPI tft = TFT_eSPI();
+TFT_eSprite spr = TFT_eSprite(&tft);
+
+#if defined(TFT_SPI_WRITE)
+  #define BENCH_BUS "SPI"
+#elif defined(TFT_PIO_SPI_WRITE)
+  #define BENCH_BUS "PIO_SPI"
+#elif defined(TFT_PIO_8BITP_WRITE)
+  #define BENCH_BUS "PIO_8BITP"
+#elif defined(TFT_GPIO_8BITP_WRITE)
+  #define BENCH_BUS "GPIO_8BITP"
+#elif defined(TFT_VIRTUAL_WRITE)
+  #define BENCH_BUS "VIRTUAL"
+#else
+  #define BENCH_BUS "NONE"
+#endif
+
+#if defined(COLOR_565)
+  #define BENCH_COLOR "565"
+#else
+  #define BENCH_COLOR "666"
+#endif
+
+#if defined(SMOOTH_FIXED)
+  #define BENCH_MATH "fixed"
+#else
+  #define BENCH_MATH "float"
+#endif
+
+#if !defined(TFT_SHADOW)
+  #define BENCH_SHADOW "none"
+#elif TFT_SHADOW_DEPTH == 8
+  #define BENCH_SHADOW "8"
+#else
+  #define BENCH_SHADOW "16"
+#endif
+
+// ------------------------------ helpers ------------------------------------
+
+static uint32_t seed = 1;
+
+// deterministic pseudo random numbers, the same on every target
+static int32_t rnd(int32_t n)
+{
+  seed = seed * 1103515245 + 12345;
+  return (int32_t)((seed >> 16) % (uint32_t)n);
+}
+
+static rgb_t rndColor()
+{
+  return RGB(rnd(256), rnd(256), rnd(256));
+}
+
+static bool first = true;
+
+static void run(const char* name, int32_t ops, void (*test)(int32_t))
+{
+  seed = 1;
+  tft.fillScreen(TFT_BLACK);
+
+#ifdef TFT_BUS_STATS
+  tft.resetBusStats();
+#endif
+  uint32_t t = micros();
+  test(ops);
+  t = micros() - t;
+
+  printf("%s\n  {\"name\":\"%s\",\"ops\":%ld,\"us\":%lu", first ? "" : ",", name, (long)ops, (unsigned long)t);
+#ifdef TFT_BUS_STATS
+  const bus_count_t& c = tft.getBusStats().total;
+  printf(",\"windows\":%lu,\"pixels\":%lu,\"reads\":%lu,\"transactions\":%lu",
+    (unsigned long)c.windows, (unsigned long)c.pixels, (unsigned long)c.reads, (unsigned long)c.transactions);
+  bus_time_t w;
+  tft.getBusTime(c, w);
+  printf(",\"wire_us\":%lu,\"wire_window_us\":%lu,\"wire_pixel_us\":%lu,\"wire_read_us\":%lu",
+    (unsigned long)w.totalUs, (unsigned long)w.windowUs, (unsigned long)w.pixelUs, (unsigned long)w.readUs);
+#endif
+  printf("}");
+  first = false;
+}
+
+// ------------------------------ images -------------------------------------
+
+#define IMG_W 64
+#define IMG_H 48
+
+static uint16_t img16[IMG_W * IMG_H];
+static uint8_t  img8[IMG_W * IMG_H];
+static uint8_t  img4[IMG_W * IMG_H / 2];
+static uint8_t  img1[(IMG_W + 7) / 8 * IMG_H];
+
+static void makeImages()
+{
+  for (int32_t y = 0; y < IMG_H; ++y) {
+    for (int32_t x = 0; x < IMG_W; ++x) {
+      int32_t i = y * IMG_W + x;
+      uint16_t c = ((x * 31 / IMG_W) << 11) | ((y * 63 / IMG_H) << 5) | ((x ^ y) & 0x1F);
+      img16[i] = c >> 8 | c << 8;   // as pushed by Sprites, high byte first
+      img8[i] = (x & 0xE0) | ((y >> 3) & 0x1C) | (x & 3);
+    }
+  }
+  for (int32_t i = 0; i < IMG_W * IMG_H / 2; ++i) img4[i] = (i & 0x0F) << 4 | ((i >> 4) & 0x0F);
+  for (uint32_t i = 0; i < sizeof(img1); ++i) img1[i] = (i & 1) ? 0xA5 : 0x3C;
+}
+
+// ------------------------------ smooth font --------------------------------
+
+// There is no vlw font in the library, so a small one is built in RAM,
+// digits 0..9, 16 x 20 anti-aliased rings, enough to exercise drawGlyph()
+
+#define VLW_COUNT 10
+#define VLW_W 16
+#define VLW_H 20
+
+static uint8_t vlw[24 + 28 * VLW_COUNT + VLW_COUNT * VLW_W * VLW_H];
+
+static uint8_t* putInt32(uint8_t* p, int32_t v)
+{
+  p[0] = v >> 24; p[1] = v >> 16; p[2] = v >> 8; p[3] = v;
+  return p + 4;
+}
+
+static void makeVlw()
+{
+  uint8_t* p = vlw;
+  p = putInt32(p, VLW_COUNT);
+  p = putInt32(p, 11);
+  p = putInt32(p, VLW_H);
+  p = putInt32(p, 0);
+  p = putInt32(p, VLW_H);   // ascent
+  p = putInt32(p, 4);       // descent
+  for (int32_t g = 0; g < VLW_COUNT; ++g) {
+    p = putInt32(p, '0' + g);
+    p = putInt32(p, VLW_H);
+    p = putInt32(p, VLW_W);
+    p = putInt32(p, VLW_W + 2);
+    p = putInt32(p, VLW_H);
+    p = putInt32(p, 1);
+    p = putInt32(p, 0);
+  }
+  for (int32_t g = 0; g < VLW_COUNT; ++g) {
+    float r = 4 + g * 0.4f;
+    for (int32_t y = 0; y < VLW_H; ++y) {
+      for (int32_t x = 0; x < VLW_W; ++x) {
+        float dx = x - VLW_W / 2 + 0.5f, dy = y - VLW_H / 2 + 0.5f;
+        float d = fabsf(sqrtf(dx * dx + dy * dy) - r) - 1.0f;
+        *p++ = d <= 0 ? 255 : d >= 1 ? 0 : (uint8_t)(255 * (1 - d));
+      }
+    }
+  }
+}
+
+// ------------------------------ tests --------------------------------------
+
+static void testFillScreen(int32_t n)
+{
+  for (int32_t i = 0; i < n; ++i) tft.fillScreen(i & 1 ? TFT_RED : TFT_BLUE);
+}
+
+static void testFillRect(int32_t n)
+{
+  for (int32_t i = 0; i < n; ++i) tft.fillRect(rnd(tft.width()), rnd(tft.height()), rnd(60) + 1, rnd(60) + 1, rndColor());
+}
+
+static void testFillRectSmall(int32_t n)
+{
+  for (int32_t i = 0; i < n; ++i) tft.fillRect(rnd(tft.width()), rnd(tft.height()), rnd(4) + 1, rnd(4) + 1, rndColor());
+}
+
+static void testDrawRect(int32_t n)
+{
+  for (int32_t i = 0; i < n; ++i) tft.drawRect(rnd(tft.width()), rnd(tft.height()), rnd(60) + 2, rnd(60) + 2, rndColor());
+}
+
+static void testFastLines(int32_t n)
+{
+  for (int32_t i = 0; i < n; ++i) {
+    tft.drawFastHLine(rnd(tft.width()), rnd(tft.height()), rnd(100) + 1, rndColor());
+    tft.drawFastVLine(rnd(tft.width()), rnd(tft.height()), rnd(100) + 1, rndColor());
+  }
+}
+
+static void testDrawLine(int32_t n)
+{
+  for (int32_t i = 0; i < n; ++i) tft.drawLine(rnd(tft.width()), rnd(tft.height()), rnd(tft.width()), rnd(tft.height()), rndColor());
+}
+
+// Zoomed chart, long lines mostly outside the screen
+static void testDrawLineClipped(int32_t n)
+{
+  int32_t w = tft.width(), h = tft.height();
+  for (int32_t i = 0; i < n; ++i)
+    tft.drawLine(rnd(20 * w) - 10 * w, rnd(20 * h) - 10 * h, rnd(20 * w) - 10 * w, rnd(20 * h) - 10 * h, rndColor());
+}
+
+static void testDrawCircle(int32_t n)
+{
+  for (int32_t i = 0; i < n; ++i) tft.drawCircle(rnd(tft.width()), rnd(tft.height()), rnd(40) + 2, rndColor());
+}
+
+static void testFillCircle(int32_t n)
+{
+  for (int32_t i = 0; i < n; ++i) tft.fillCircle(rnd(tft.width()), rnd(tft.height()), rnd(40) + 2, rndColor());
+}
+
+static void testFillTriangle(int32_t n)
+{
+  for (int32_t i = 0; i < n; ++i) {
+    int32_t x = rnd(tft.width()), y = rnd(tft.height());
+    tft.fillTriangle(x, y, x + rnd(80) - 40, y + rnd(80) - 40, x + rnd(80) - 40, y + rnd(80) - 40, rndColor());
+  }
+}
+
+static void testFillRoundRect(int32_t n)
+{
+  for (int32_t i = 0; i < n; ++i) tft.fillRoundRect(rnd(tft.width()), rnd(tft.height()), rnd(60) + 10, rnd(60) + 10, 5, rndColor());
+}
+
+static void testDrawSmoothArc(int32_t n)
+{
+  for (int32_t i = 0; i < n; ++i) {
+    int32_t r = rnd(40) + 20;
+    tft.drawSmoothArc(rnd(tft.width()), rnd(tft.height()), r, r - rnd(10) - 2, rnd(180), rnd(180) + 180, rndColor(), TFT_BLACK, true);
+  }
+}
+
+static void testDrawArc(int32_t n)
+{
+  for (int32_t i = 0; i < n; ++i) {
+    int32_t r = rnd(40) + 20;
+    tft.drawArc(rnd(tft.width()), rnd(tft.height()), r, r - rnd(10) - 2, rnd(180), rnd(180) + 180, rndColor(), TFT_BLACK);
+  }
+}
+
+static void testFillSmoothCircle(int32_t n)
+{
+  for (int32_t i = 0; i < n; ++i) tft.fillSmoothCircle(rnd(tft.width()), rnd(tft.height()), rnd(30) + 2, rndColor(), TFT_BLACK);
+}
+
+static void testDrawWedgeLine(int32_t n)
+{
+  for (int32_t i = 0; i < n; ++i) {
+    tft.drawWedgeLine(rnd(tft.width()), rnd(tft.height()), rnd(tft.width()), rnd(tft.height()),
+                      rnd(8) + 1, rnd(8) + 1, rndColor(), TFT_BLACK);
+  }
+}
+
+static void testDrawWedgeLineRead(int32_t n)
+{
+  // no background colour, every edge pixel is read from the screen
+  for (int32_t i = 0; i < n; ++i) {
+    tft.drawWedgeLine(rnd(tft.width()), rnd(tft.height()), rnd(tft.width()), rnd(tft.height()),
+                      rnd(8) + 1, rnd(8) + 1, rndColor());
+  }
+}
+
+static void testDrawSpot(int32_t n)
+{
+  for (int32_t i = 0; i < n; ++i) tft.drawSpot(rnd(tft.width() * 4) / 4.0f, rnd(tft.height() * 4) / 4.0f, rnd(40) / 4.0f + 1, rndColor(), TFT_BLACK);
+}
+
+static void testDrawWideLine(int32_t n)
+{
+  for (int32_t i = 0; i < n; ++i) {
+    tft.drawWideLine(rnd(tft.width() * 4) / 4.0f, rnd(tft.height() * 4) / 4.0f, rnd(tft.width() * 4) / 4.0f, rnd(tft.height() * 4) / 4.0f,
+                     rnd(24) / 4.0f + 1, rndColor(), TFT_BLACK);
+  }
+}
+
+static void testGradientH(int32_t n)
+{
+  for (int32_t i = 0; i < n; ++i) tft.fillRectHGradient(rnd(tft.width() / 2), rnd(tft.height() / 2), 100, 60, rndColor(), rndColor());
+}
+
+static void testGradientV(int32_t n)
+{
+  for (int32_t i = 0; i < n; ++i) tft.fillRectVGradient(rnd(tft.width() / 2), rnd(tft.height() / 2), 100, 60, rndColor(), rndColor());
+}
+
+static void testPushImage16(int32_t n)
+{
+  for (int32_t i = 0; i < n; ++i) tft.pushImage(rnd(tft.width()) - IMG_W / 2, rnd(tft.height()) - IMG_H / 2, IMG_W, IMG_H, img16);
+}
+
+static void testPushImage16Transp(int32_t n)
+{
+  for (int32_t i = 0; i < n; ++i) tft.pushImage(rnd(tft.width()) - IMG_W / 2, rnd(tft.height()) - IMG_H / 2, IMG_W, IMG_H, img16, img16[0]);
+}
+
+static void testPushImage8(int32_t n)
+{
+  for (int32_t i = 0; i < n; ++i) tft.pushImage(rnd(tft.width()) - IMG_W / 2, rnd(tft.height()) - IMG_H / 2, IMG_W, IMG_H, img8, true);
+}
+
+static void testPushImage4(int32_t n)
+{
+  for (int32_t i = 0; i < n; ++i) tft.pushImage(rnd(tft.width()) - IMG_W / 2, rnd(tft.height()) - IMG_H / 2, IMG_W, IMG_H, img4, false, (uint16_t*)default_4bit_palette);
+}
+
+static void testPushImage1(int32_t n)
+{
+  tft.setBitmapColor(TFT_WHITE, TFT_NAVY);
+  for (int32_t i = 0; i < n; ++i) tft.pushImage(rnd(tft.width()) - IMG_W / 2, rnd(tft.height()) - IMG_H / 2, IMG_W, IMG_H, img1, false);
+}
+
+static void testText(int32_t n, uint8_t font, const char* text, bool bg)
+{
+  if (bg) tft.setTextColor(TFT_WHITE, TFT_BLUE);
+  else tft.setTextColor(TFT_WHITE);
+  for (int32_t i = 0; i < n; ++i) tft.drawString(text, rnd(tft.width() / 2), rnd(tft.height() - 80), font);
+}
+
+static void testGlcd(int32_t n)     { testText(n, 1, "Hello World 0123", true); }
+static void testGlcdTransp(int32_t n) { testText(n, 1, "Hello World 0123", false); }
+static void testFont2(int32_t n)    { testText(n, 2, "Hello World 0123", true); }
+static void testFont4(int32_t n)    { testText(n, 4, "Hello 0123", false); }
+static void testFont4Bg(int32_t n)  { testText(n, 4, "Hello 0123", true); }
+static void testFont6(int32_t n)    { testText(n, 6, "12:34", false); }
+static void testFont7(int32_t n)    { testText(n, 7, "12:34", false); }
+static void testFont8(int32_t n)    { testText(n, 8, "123", false); }
+
+static void testSmoothFont(int32_t n)
+{
+  tft.loadFont(vlw);
+  tft.setTextColor(TFT_WHITE, TFT_BLACK);
+  for (int32_t i = 0; i < n; ++i) tft.drawString("0123456789", rnd(tft.width() / 2), rnd(tft.height() - 30));
+  tft.unloadFont();
+}
+
+static void testSprite16(int32_t n)
+{
+  spr.setColorDepth(16);
+  spr.createSprite(100, 60);
+  for (int32_t i = 0; i < n; ++i) {
+    spr.fillSprite(rndColor());
+    spr.fillCircle(50, 30, 25, rndColor());
+    spr.drawLine(0, 0, 99, 59, rndColor());
+    spr.setTextColor(TFT_WHITE);
+    spr.drawString("Sprite", 10, 20, 2);
+    spr.pushSprite(rnd(tft.width() - 100), rnd(tft.height() - 60));
+  }
+  spr.deleteSprite();
+}
+
+static void testSprite8(int32_t n)
+{
+  spr.setColorDepth(8);
+  spr.createSprite(100, 60);
+  for (int32_t i = 0; i < n; ++i) {
+    spr.fillSprite(rndColor());
+    spr.fillRect(10, 10, 50, 30, rndColor());
+    spr.pushSprite(rnd(tft.width() - 100), rnd(tft.height() - 60));
+  }
+  spr.deleteSprite();
+}
+
+static void testSprite4(int32_t n)
+{
+  spr.setColorDepth(4);
+  spr.createSprite(100, 60);
+  for (int32_t i = 0; i < n; ++i) {
+    spr.fillSprite(rnd(16));
+    spr.fillRect(10, 10, 50, 30, rnd(16));
+    spr.pushSprite(rnd(tft.width() - 100), rnd(tft.height() - 60));
+  }
+  spr.deleteSprite();
+}
+
+static void testSpriteTransp(int32_t n)
+{
+  spr.setColorDepth(16);
+  spr.createSprite(100, 60);
+  spr.fillSprite(TFT_BLACK);
+  spr.fillCircle(50, 30, 25, TFT_YELLOW);
+  for (int32_t i = 0; i < n; ++i) spr.pushSprite(rnd(tft.width() - 100), rnd(tft.height() - 60), TFT_BLACK);
+  spr.deleteSprite();
+}
+
+static void testSpriteDraw(int32_t n)
+{
+  // drawing into the Sprite only, no bus traffic expected
+  spr.setColorDepth(16);
+  spr.createSprite(200, 150);
+  for (int32_t i = 0; i < n; ++i) {
+    spr.fillRect(rnd(200), rnd(150), rnd(60) + 1, rnd(60) + 1, rndColor());
+    spr.drawLine(rnd(200), rnd(150), rnd(200), rnd(150), rndColor());
+    spr.fillCircle(rnd(200), rnd(150), rnd(20) + 1, rndColor());
+    spr.drawWedgeLine(rnd(200), rnd(150), rnd(200), rnd(150), 1, 4, rndColor(), TFT_BLACK);
+  }
+  spr.deleteSprite();
+}
+
+static void testFrame(int32_t n)
+{
+  // a gauge redrawn in layers, each pixel is drawn several times a frame
+  tft.setTextColor(TFT_WHITE, TFT_NAVY);
+  for (int32_t i = 0; i < n; ++i) {
+    int32_t a = rnd(360);
+    tft.fillRect(20, 40, 200, 200, TFT_NAVY);
+    tft.fillCircle(120, 140, 90, TFT_DARKGREY);
+    tft.fillCircle(120, 140, 80, TFT_BLACK);
+    tft.drawWedgeLine(120, 140, 120 + 70 * cosf(a * 0.0174533f), 140 + 70 * sinf(a * 0.0174533f),
+                      6, 1, TFT_RED, TFT_BLACK);
+    tft.drawNumber(a, 100, 250, 4);
+#ifdef TFT_SHADOW
+    tft.flushShadow();
+#endif
+  }
+}
+
+#ifdef TFT_SHADOW
+static void testFrameDeferred(int32_t n)
+{
+  tft.setShadowDefer(true);
+  testFrame(n);
+  tft.setShadowDefer(false);
+}
+#endif
+
+// ------------------------------ sketch -------------------------------------
+
+void setup()
+{
+  tft.init();
+  tft.setRotation(0);
+#ifdef TFT_SHADOW
+  tft.createShadow();
+#endif
+
+  makeImages();
+  makeVlw();
+
+  printf("{\"library\":\"%s\",\"bus\":\"%s\",\"color\":\"%s\",\"math\":\"%s\",\"shadow\":\"%s\",\"width\":%d,\"height\":%d,\"results\":[",
+    TFT_ESPI_VERSION, BENCH_BUS, BENCH_COLOR, BENCH_MATH, BENCH_SHADOW, (int)tft.width(), (int)tft.height());
+
+  run("fillScreen",          10, testFillScreen);
+  run("fillRect",           200, testFillRect);
+  run("fillRectSmall",     1000, testFillRectSmall);
+  run("drawRect",           200, testDrawRect);
+  run("drawFastHVLine",     500, testFastLines);
+  run("drawLine",           200, testDrawLine);
+  run("drawLineClipped",    200, testDrawLineClipped);
+  run("drawCircle",         100, testDrawCircle);
+  run("fillCircle",         100, testFillCircle);
+  run("fillTriangle",       100, testFillTriangle);
+  run("fillRoundRect",      100, testFillRoundRect);
+  run("drawSmoothArc",       20, testDrawSmoothArc);
+  run("drawArc",             20, testDrawArc);
+  run("fillSmoothCircle",    50, testFillSmoothCircle);
+  run("drawWedgeLine",       50, testDrawWedgeLine);
+  run("drawWedgeLineRead",   50, testDrawWedgeLineRead);
+  run("drawSpot",           100, testDrawSpot);
+  run("drawWideLine",        50, testDrawWideLine);
+  run("fillRectHGradient",   50, testGradientH);
+  run("fillRectVGradient",   50, testGradientV);
+  run("pushImage16",        100, testPushImage16);
+  run("pushImage16Transp",  100, testPushImage16Transp);
+  run("pushImage8",         100, testPushImage8);
+  run("pushImage4",         100, testPushImage4);
+  run("pushImage1",         100, testPushImage1);
+  run("drawStringGLCD",     100, testGlcd);
+  run("drawStringGLCDTransp", 100, testGlcdTransp);
+  run("drawStringFont2",    100, testFont2);
+  run("drawStringFont4",     50, testFont4);
+  run("drawStringFont4Bg",   50, testFont4Bg);
+  run("drawStringFont6",     20, testFont6);
+  run("drawStringFont7",     20, testFont7);
+  run("drawStringFont8",     20, testFont8);
+  run("drawStringSmooth",    50, testSmoothFont);
+  run("sprite16",            50, testSprite16);
+  run("sprite8",             50, testSprite8);
+  run("sprite4",             50, testSprite4);
+  run("spriteTransp",        50, testSpriteTransp);
+  run("spriteDraw",         200, testSpriteDraw);
+  run("frame",               50, testFrame);
+#ifdef TFT_SHADOW
+  run("frameDeferred",       50, testFrameDeferred);
+#endif
+
+  printf("\n]}\n");
+}
+
+void loop()
+{
+#if defined(TFT_VIRTUAL_WRITE)
+  exit(0);
+#endif
+  while(1) yield();
+}